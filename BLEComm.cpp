@@ -2,8 +2,16 @@
 #include "Config.h"
 #include <ArduinoJson.h>
 
-BLEComm::BLEComm() : pServer(nullptr), pCharacteristic(nullptr),
-                     deviceConnected(false), dataAvailable(false), lastReceiveTime(0) {
+BLEComm::BLEComm() : CommInterface(COMM_BLE), pServer(nullptr), pCharacteristic(nullptr),
+                     pFeedback(nullptr), deviceConnected(false), lastReceiveTime(0),
+                     connectEvents(0), disconnectEvents(0), connectsHandled(0),
+                     disconnectsHandled(0), stateSince(0),
+                     assemblySlot(nullptr), assemblyId(0), assemblyNext(0) {
+    memset(&stats, 0, sizeof(stats));
+    memset(peerAddress, 0, sizeof(peerAddress));
+    stats.mtu = 23;
+    stats.state = BLE_STATE_OFF;
+    stats.activeProfile = BLE_PROFILE_AUTO;
 }
 
 BLEComm::~BLEComm() {
@@ -12,11 +20,12 @@ BLEComm::~BLEComm() {
 
 bool BLEComm::begin() {
     Config& cfg = Config::getInstance();
-    String bleName = cfg.getBLEName();
+    const String& bleName = cfg.getBLEName();
 
     Serial.printf("Initializing BLE: %s\n", bleName.c_str());
 
     BLEDevice::init(bleName.c_str());
+    BLEDevice::setMTU(BLE_PREFERRED_MTU);
     pServer = BLEDevice::createServer();
     pServer->setCallbacks(this);
 
@@ -26,12 +35,20 @@ bool BLEComm::begin() {
         CHARACTERISTIC_UUID,
         BLECharacteristic::PROPERTY_READ |
         BLECharacteristic::PROPERTY_WRITE |
+        BLECharacteristic::PROPERTY_WRITE_NR |
         BLECharacteristic::PROPERTY_NOTIFY
     );
 
     pCharacteristic->setCallbacks(this);
     pCharacteristic->addDescriptor(new BLE2902());
 
+    pFeedback = pService->createCharacteristic(
+        FEEDBACK_CHARACTERISTIC_UUID,
+        BLECharacteristic::PROPERTY_READ |
+        BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pFeedback->addDescriptor(new BLE2902());
+
     pService->start();
 
     BLEAdvertising* pAdvertising = BLEDevice::getAdvertising();
@@ -40,31 +57,138 @@ bool BLEComm::begin() {
     pAdvertising->setMinPreferred(0x06);
     pAdvertising->setMinPreferred(0x12);
     BLEDevice::startAdvertising();
+    stats.advertisingStarts++;
+    setState(BLE_STATE_ADVERTISING);
 
     Serial.println("BLE advertising started");
     return true;
 }
 
 void BLEComm::update() {
-    // Handle reconnection if needed
-    if (!deviceConnected && pServer->getConnectedCount() == 0) {
-        delay(500);
-        pServer->startAdvertising();
+    if (!pServer) {
+        return;
+    }
+
+    // Never blocks: connection events are counted by the stack task and
+    // handled here, advertising restarts are scheduled instead of delayed
+    unsigned long now = millis();
+
+    uint32_t connects = connectEvents.load() - connectsHandled;
+    uint32_t disconnects = disconnectEvents.load() - disconnectsHandled;
+    connectsHandled += connects;
+    disconnectsHandled += disconnects;
+
+    if (disconnects > 0) {
+        stats.disconnects += disconnects;
+        if (stats.state == BLE_STATE_CONNECTED) {
+            stats.connectedTotal += now - stats.connectedSince;
+        }
+    }
+    stats.connections += connects;
+
+    // The newest event decides the state: a disconnect followed by a
+    // reconnect is a new connection, a reconnect that dropped again
+    // restarts advertising
+    if (connects > 0 || disconnects > 0) {
+        if (deviceConnected) {
+            if (stats.state != BLE_STATE_CONNECTED || disconnects > 0) {
+                stats.connectedSince = now;
+                setState(BLE_STATE_CONNECTED);
+                stats.activeProfile = BLE_PROFILE_AUTO;  // Nothing requested on this link yet
+            }
+        } else {
+            setState(BLE_STATE_RESTART_PENDING);
+        }
+    }
+
+    switch (stats.state) {
+        case BLE_STATE_RESTART_PENDING:
+            if (now - stateSince >= BLE_ADV_RESTART_DELAY) {
+                pServer->startAdvertising();
+                stats.advertisingStarts++;
+                setState(BLE_STATE_ADVERTISING);
+                Serial.println("BLE advertising restarted");
+            }
+            break;
+        case BLE_STATE_CONNECTED:
+            applyProfile();
+            break;
+        default:
+            break;
     }
 }
 
+void BLEComm::setState(BLELinkState state) {
+    stats.state = state;
+    stateSince = millis();
+}
+
+void BLEComm::applyProfile() {
+    BLEProfile wanted = Config::getInstance().getBLEProfile();
+    if (wanted == BLE_PROFILE_AUTO) {
+        bool idle = millis() - (lastReceiveTime ? lastReceiveTime : stats.connectedSince) > BLE_IDLE_TIMEOUT;
+        wanted = idle ? BLE_PROFILE_LOW_POWER : BLE_PROFILE_LOW_LATENCY;
+    }
+
+    if (wanted == stats.activeProfile) {
+        return;
+    }
+
+    if (wanted == BLE_PROFILE_LOW_LATENCY) {
+        pServer->updateConnParams(peerAddress, BLE_LOW_LATENCY_MIN_INTERVAL, BLE_LOW_LATENCY_MAX_INTERVAL,
+                                  BLE_LOW_LATENCY_LATENCY, BLE_LOW_LATENCY_TIMEOUT);
+    } else {
+        pServer->updateConnParams(peerAddress, BLE_LOW_POWER_MIN_INTERVAL, BLE_LOW_POWER_MAX_INTERVAL,
+                                  BLE_LOW_POWER_LATENCY, BLE_LOW_POWER_TIMEOUT);
+    }
+    stats.activeProfile = wanted;
+    stats.paramUpdates++;
+    Serial.printf("BLE connection parameters: %s\n",
+                  wanted == BLE_PROFILE_LOW_LATENCY ? "low latency" : "low power");
+}
+
 bool BLEComm::isConnected() {
     return deviceConnected;
 }
 
 bool BLEComm::receiveData(SystemData& data) {
-    if (dataAvailable) {
-        dataAvailable = false;
-        bool result = parseJSON(receivedData.c_str(), data);
-        receivedData = "";
-        return result;
+    // Apply every queued write in order; only the newest state leaves this call
+    uint32_t received = 0;
+    noteQueueDepth(rxRing.size(), rxRing.capacity());
+    while (BLERxSlot* slot = rxRing.peek()) {
+        TelemetryFrame frame;
+        const uint8_t* payload = slot->data;
+        size_t length = slot->length;
+        if (FrameDecompressor::isCompressed(payload, length)) {
+            payload = decompressor.decompress(slot->data, slot->length, length);
+        }
+        if (payload && decodePayload(payload, length, frame)) {
+            frame.receivedAt = slot->receivedAt;
+            frame.length = slot->length;   // Bytes on air
+            if (applyFrame(frame, data)) {
+                received++;
+            }
+        }
+        rxRing.release();
+    }
+    setOverflows(rxRing.overflows());
+
+    if (received == 0) {
+        return false;
     }
-    return false;
+
+    lastReceiveTime = millis();
+    countCoalesced(received - 1);
+    return true;
+}
+
+void BLEComm::sendFeedback(const uint8_t* message, size_t length) {
+    if (!pFeedback || !deviceConnected) {
+        return;
+    }
+    pFeedback->setValue((uint8_t*)message, length);
+    pFeedback->notify();
+    stats.feedbackSent++;
 }
 
 void BLEComm::stop() {
@@ -72,26 +196,116 @@ void BLEComm::stop() {
         BLEDevice::deinit(true);
         pServer = nullptr;
         pCharacteristic = nullptr;
+        pFeedback = nullptr;
     }
     deviceConnected = false;
+    stats.state = BLE_STATE_OFF;
 }
 
 // BLE callbacks
-void BLEComm::onConnect(BLEServer* pServer) {
+void BLEComm::onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+    memcpy(peerAddress, param->connect.remote_bda, sizeof(peerAddress));
     deviceConnected = true;
+    connectEvents++;
     Serial.println("BLE client connected");
 }
 
 void BLEComm::onDisconnect(BLEServer* pServer) {
     deviceConnected = false;
+    disconnectEvents++;
+    stats.mtu = 23;
     Serial.println("BLE client disconnected");
 }
 
+void BLEComm::onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) {
+    stats.mtu = param->mtu.mtu;
+    Serial.printf("BLE MTU negotiated: %d\n", stats.mtu);
+}
+
 void BLEComm::onWrite(BLECharacteristic* pCharacteristic) {
-    String value = pCharacteristic->getValue().c_str();
-    if (value.length() > 0) {
-        receivedData = value;
-        dataAvailable = true;
-        lastReceiveTime = millis();
+    // Runs on the Bluetooth stack task: copy into a ring slot, no heap use
+    const uint8_t* data = pCharacteristic->getData();
+    size_t length = pCharacteristic->getLength();
+    if (length == 0) {
+        return;
+    }
+    stats.writes++;
+
+    if (data[0] == BLE_FRAG_MAGIC) {
+        handleFragment(data, length);
+        return;
+    }
+
+    // Unframed write: one complete message. It reuses the ring's free slot,
+    // so any message still being reassembled there is abandoned.
+    if (assemblySlot) {
+        stats.reassemblyErrors++;
+        assemblySlot = nullptr;
+    }
+
+    BLERxSlot* slot = rxRing.acquire();
+    if (!slot) {
+        return;  // Counted as an overflow by the ring
+    }
+
+    if (length > sizeof(slot->data)) {
+        length = sizeof(slot->data);
+    }
+    memcpy(slot->data, data, length);
+    slot->length = length;
+    slot->receivedAt = millis();
+    rxRing.commit();
+}
+
+void BLEComm::handleFragment(const uint8_t* data, size_t length) {
+    if (length < BLE_FRAG_HEADER) {
+        stats.reassemblyErrors++;
+        return;
+    }
+    stats.fragments++;
+
+    uint8_t id = data[1];
+    uint8_t index = data[2] & BLE_FRAG_INDEX_MASK;
+    bool last = data[2] & BLE_FRAG_LAST;
+    data += BLE_FRAG_HEADER;
+    length -= BLE_FRAG_HEADER;
+
+    if (index == 0) {
+        // First fragment; abandons any incomplete message. The slot stays
+        // acquired (but unpublished) until the last fragment arrives.
+        if (assemblySlot) {
+            stats.reassemblyErrors++;
+        }
+        assemblySlot = rxRing.acquire();
+        if (!assemblySlot) {
+            return;  // Ring full: drop the whole message
+        }
+        assemblySlot->length = 0;
+        assemblyId = id;
+        assemblyNext = 0;
+    } else if (!assemblySlot || id != assemblyId || index != assemblyNext) {
+        // Lost or reordered fragment: the message can't be completed
+        if (assemblySlot) {
+            stats.reassemblyErrors++;
+            assemblySlot = nullptr;
+        }
+        return;
+    }
+
+    if (assemblySlot->length + length > sizeof(assemblySlot->data)) {
+        stats.reassemblyErrors++;
+        assemblySlot = nullptr;
+        return;
+    }
+
+    memcpy(assemblySlot->data + assemblySlot->length, data, length);
+    assemblySlot->length += length;
+    assemblyNext++;
+
+    if (last) {
+        assemblySlot->receivedAt = millis();
+        rxRing.commit();
+        assemblySlot = nullptr;
+        stats.reassembled++;
     }
 }
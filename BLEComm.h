@@ -2,14 +2,85 @@
 #define BLE_COMM_H
 
 #include "CommInterface.h"
+#include "Config.h"
 #include <BLEDevice.h>
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#include <atomic>
+#include "SpscRing.h"
+#include "FrameCompression.h"
 
-// UUIDs for BLE service and characteristic
+// UUIDs for BLE service and characteristics. Feedback has its own
+// characteristic so notifying never touches the value writes land in.
 #define SERVICE_UUID        "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
 #define CHARACTERISTIC_UUID "beb5483e-36e1-4688-b7f5-ea07361b26a8"
+#define FEEDBACK_CHARACTERISTIC_UUID "beb5483e-36e1-4688-b7f5-ea07361b26a9"
+
+// MTU requested during negotiation (ATT maximum)
+#define BLE_PREFERRED_MTU 517
+
+// Receive ring between the Bluetooth stack task and loop(). Each slot holds
+// one complete (reassembled) message.
+#define BLE_RX_RING_SIZE 2
+#define BLE_MAX_MESSAGE 2048
+
+// Fragment framing for messages larger than one write:
+//   [BLE_FRAG_MAGIC][message id][bit 7: last fragment | bits 0-6: index] payload
+// Writes that don't start with the magic byte are complete messages.
+#define BLE_FRAG_MAGIC      0xFE
+#define BLE_FRAG_HEADER     3
+#define BLE_FRAG_LAST       0x80
+#define BLE_FRAG_INDEX_MASK 0x7F
+
+// Advertising restart delay after a disconnect, lets the stack settle
+#define BLE_ADV_RESTART_DELAY 500
+
+// Without writes for this long the auto profile drops to low power (ms)
+#define BLE_IDLE_TIMEOUT 10000
+
+// Connection parameters (interval in 1.25 ms units, timeout in 10 ms units)
+#define BLE_LOW_LATENCY_MIN_INTERVAL 6     // 7.5 ms
+#define BLE_LOW_LATENCY_MAX_INTERVAL 12    // 15 ms
+#define BLE_LOW_LATENCY_LATENCY      0
+#define BLE_LOW_LATENCY_TIMEOUT      200   // 2 s
+#define BLE_LOW_POWER_MIN_INTERVAL   80    // 100 ms
+#define BLE_LOW_POWER_MAX_INTERVAL   160   // 200 ms
+#define BLE_LOW_POWER_LATENCY        4
+#define BLE_LOW_POWER_TIMEOUT        600   // 6 s
+
+enum BLELinkState {
+    BLE_STATE_OFF,
+    BLE_STATE_ADVERTISING,
+    BLE_STATE_CONNECTED,
+    BLE_STATE_RESTART_PENDING   // Disconnected, advertising restarts shortly
+};
+
+struct BLERxSlot {
+    uint16_t length;
+    unsigned long receivedAt;
+    uint8_t data[BLE_MAX_MESSAGE];
+};
+
+// Link counters. Write/fragment counters and mtu are written by the
+// Bluetooth stack task, the rest by loop().
+struct BLELinkStats {
+    uint16_t mtu;
+    uint32_t writes;
+    uint32_t fragments;
+    uint32_t reassembled;       // Multi-fragment messages completed
+    uint32_t reassemblyErrors;  // Out-of-order, missing or oversized fragments
+
+    BLELinkState state;
+    BLEProfile activeProfile;   // Parameters last requested (AUTO: none yet)
+    uint32_t connections;
+    uint32_t disconnects;
+    uint32_t advertisingStarts;
+    uint32_t paramUpdates;
+    unsigned long connectedSince;
+    unsigned long connectedTotal;  // ms, completed connections only
+    uint32_t feedbackSent;      // Feedback notifications
+};
 
 class BLEComm : public CommInterface, public BLEServerCallbacks, public BLECharacteristicCallbacks {
 public:
@@ -23,17 +94,43 @@ public:
     void stop() override;
 
     // BLE callbacks
-    void onConnect(BLEServer* pServer) override;
+    void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) override;
     void onDisconnect(BLEServer* pServer) override;
+    void onMtuChanged(BLEServer* pServer, esp_ble_gatts_cb_param_t* param) override;
     void onWrite(BLECharacteristic* pCharacteristic) override;
 
+    const BLELinkStats& getStats() const { return stats; }
+    const FrameDecompressor& getDecompressor() const { return decompressor; }
+
 private:
     BLEServer* pServer;
     BLECharacteristic* pCharacteristic;
-    bool deviceConnected;
-    bool dataAvailable;
-    String receivedData;
+    BLECharacteristic* pFeedback;
+    std::atomic<bool> deviceConnected;
+    SpscRing<BLERxSlot, BLE_RX_RING_SIZE> rxRing;
     unsigned long lastReceiveTime;
+    BLELinkStats stats;
+    FrameDecompressor decompressor;   // Airtime is scarce, so BLE takes compressed frames (loop() only)
+
+    // Connection events from the Bluetooth stack task, counted so update()
+    // sees every one even when a disconnect and a reconnect share a pass
+    std::atomic<uint32_t> connectEvents;
+    std::atomic<uint32_t> disconnectEvents;
+    uint32_t connectsHandled;
+    uint32_t disconnectsHandled;
+    uint8_t peerAddress[6];
+    unsigned long stateSince;
+
+    void setState(BLELinkState state);
+    void applyProfile();
+    void sendFeedback(const uint8_t* message, size_t length) override;
+
+    // Reassembly state (Bluetooth stack task only)
+    BLERxSlot* assemblySlot;
+    uint8_t assemblyId;
+    uint8_t assemblyNext;
+
+    void handleFragment(const uint8_t* data, size_t length);
 };
 
 #endif
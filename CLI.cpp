@@ -1,9 +1,11 @@
 #include "CLI.h"
 #include "Config.h"
+#include "CommManager.h"
 #include <WiFi.h>
 #include <stdarg.h>
 
-CLI::CLI() : cmdIndex(0) {
+CLI::CLI() : commandCount(0), cmdIndex(0), frameLength(0), inFrame(false), frameOverrun(false),
+             lastFrameByte(0), frameOverruns(0), frameHandler(nullptr), frameContext(nullptr) {
     memset(cmdBuffer, 0, CMD_BUFFER_SIZE);
 }
 
@@ -13,6 +15,7 @@ CLI& CLI::getInstance() {
 }
 
 void CLI::begin(unsigned long baudRate) {
+    Serial.setRxBufferSize(CLI_RX_BUFFER);
     Serial.begin(baudRate);
     while (!Serial && millis() < 5000); // Wait for serial with timeout
 
@@ -31,6 +34,11 @@ void CLI::update() {
     while (Serial.available()) {
         char c = Serial.read();
 
+        if (inFrame || c == CLI_FRAME_DELIMITER) {
+            handleFrameByte((uint8_t)c);
+            continue;
+        }
+
         if (c == '\n' || c == '\r') {
             // Skip if this is the second part of CRLF
             if (lastWasReturn && c == '\n') {
@@ -62,14 +70,62 @@ void CLI::update() {
             }
         }
     }
+
+    // A stray 0x00 must not swallow typed commands for long. The timeout
+    // runs only once the RX buffer is drained, so a slow loop() pass can't
+    // cut off a frame whose remaining bytes are already waiting.
+    if (inFrame && !Serial.available() && millis() - lastFrameByte > CLI_FRAME_TIMEOUT) {
+        inFrame = false;
+    }
+}
+
+void CLI::handleFrameByte(uint8_t c) {
+    lastFrameByte = millis();
+
+    if (!inFrame) {
+        // Opening delimiter
+        inFrame = true;
+        frameLength = 0;
+        frameOverrun = false;
+        return;
+    }
+
+    if (c != CLI_FRAME_DELIMITER) {
+        if (frameLength < sizeof(frameBuffer)) {
+            frameBuffer[frameLength++] = c;
+        } else if (!frameOverrun) {
+            frameOverrun = true;
+            frameOverruns++;
+        }
+        return;
+    }
+
+    // An empty frame is a doubled delimiter: treat it as the next opener
+    if (frameLength == 0) {
+        return;
+    }
+
+    inFrame = false;
+    if (!frameOverrun && frameHandler) {
+        frameHandler(frameContext, frameBuffer, frameLength);
+    }
+}
+
+void CLI::setFrameHandler(FrameHandler handler, void* context) {
+    frameHandler = handler;
+    frameContext = context;
 }
 
 void CLI::registerCommand(const char* name, const char* description, CommandHandler handler) {
-    Command cmd;
+    if (commandCount >= CLI_MAX_COMMANDS) {
+        Serial.printf("Command table full, '%s' not registered\r\n", name);
+        return;
+    }
+
+    Command& cmd = commands[commandCount++];
     cmd.name = name;
     cmd.description = description;
     cmd.handler = handler;
-    commands.push_back(cmd);
 }
 
 void CLI::processCommand(char* cmdLine) {
@@ -117,7 +173,8 @@ void CLI::processCommand(char* cmdLine) {
 void CLI::executeCommand(int argc, char* argv[]) {
     const char* cmdName = argv[0];
 
-    for (const auto& cmd : commands) {
+    for (uint8_t i = 0; i < commandCount; i++) {
+        const Command& cmd = commands[i];
         if (strcmp(cmd.name, cmdName) == 0) {
             cmd.handler(argc, argv);
             return;
@@ -130,7 +187,8 @@ void CLI::executeCommand(int argc, char* argv[]) {
 
 void CLI::showHelp() {
     println("Available commands:");
-    for (const auto& cmd : commands) {
+    for (uint8_t i = 0; i < commandCount; i++) {
+        const Command& cmd = commands[i];
         Serial.print("  ");
         Serial.print(cmd.name);
         for (int i = strlen(cmd.name); i < 15; i++) {
@@ -184,9 +242,14 @@ void CLI::cmdStatus(int argc, char* argv[]) {
     Config& cfg = Config::getInstance();
 
     cli.println("\n=== System Status ===");
-    cli.printf("Communication: %s\n", cfg.getCommInterface() == COMM_WIFI ? "WiFi" : "BLE");
-
-    if (cfg.getCommInterface() == COMM_WIFI) {
+    CommManager& comm = CommManager::getInstance();
+    uint8_t links = cfg.getCommLinks();
+    cli.printf("Communication: %s preferred, %s active%s\n",
+               CommManager::getLinkName(cfg.getCommInterface()),
+               CommManager::getLinkName(comm.getActiveLink()),
+               links == COMM_LINK_BIT(cfg.getCommInterface()) ? "" : " (multi-link)");
+
+    if (links & COMM_LINK_BIT(COMM_WIFI)) {
         cli.printf("WiFi SSID: %s\n", cfg.getWiFiSSID().c_str());
         cli.printf("WiFi Status: ");
         switch(WiFi.status()) {
@@ -212,14 +275,158 @@ void CLI::cmdStatus(int argc, char* argv[]) {
                 cli.printf("Unknown (%d)\n", WiFi.status());
                 break;
         }
-    } else {
+
+        const WiFiLinkStats* wifi = comm.getWiFiStats();
+        if (wifi) {
+            static const char* stateNames[] = {"Off", "Connecting", "Connected", "Waiting to retry"};
+            cli.printf("WiFi Link: %s\n", stateNames[wifi->state]);
+            cli.printf("WiFi Attempts: %lu, Connects: %lu, Disconnects: %lu\n",
+                       wifi->attempts, wifi->connects, wifi->disconnects);
+            if (wifi->state == WIFI_STATE_BACKOFF) {
+                cli.printf("WiFi Retry delay: %lu ms (last reason %d)\n", wifi->backoffMs, wifi->lastReason);
+            }
+            if (wifi->connects > 0) {
+                cli.printf("WiFi Last connect: %lu ms (%s), boot to IP: %lu ms\n", wifi->lastConnectMs,
+                           wifi->lastConnectFast ? "cached AP" : "scan", wifi->bootConnectMs);
+            }
+            cli.printf("WiFi Cached AP: %lu connects, %lu fallbacks to scan\n",
+                       wifi->fastConnects, wifi->fastFailures);
+        }
+
+        StaticIPConfig ipConfig = cfg.getStaticIP();
+        cli.printf("IP Mode: %s\n", ipConfig.ip != 0 ? "static" :
+                   (cfg.getWiFiFastLease() ? "DHCP (lease reuse)" : "DHCP"));
+
+        if (cfg.getMulticastGroup() != 0) {
+            cli.printf("Multicast Group: %s%s\n", IPAddress(cfg.getMulticastGroup()).toString().c_str(),
+                       wifi && wifi->connects > 0 && wifi->multicastGroup == 0 ? " (not joined)" : "");
+        }
+        if (wifi) {
+            cli.printf("WiFi Frames: %lu unicast, %lu multicast\n", wifi->unicastFrames, wifi->multicastFrames);
+            cli.printf("WiFi Feedback: %d senders, %lu replies\n", wifi->peers, wifi->feedbackSent);
+            const PlayoutBuffer* playout = comm.getWiFiPlayout();
+            if (playout && (cfg.getJitterBuffer() || playout->getStats().released > 0)) {
+                const PlayoutStats& ps = playout->getStats();
+                cli.printf("WiFi Jitter Buffer: %s, target %lu ms, added %.0f ms\n",
+                           cfg.getJitterBuffer() ? "on" : "off", ps.targetDelay, ps.averageDelay);
+                cli.printf("WiFi Playout: %lu released, %lu late drops (%.2f%%), %lu early, %lu resets\n",
+                           ps.released, ps.lateDrops, playout->getLateDropRate(), ps.early, ps.resets);
+            }
+            if (wifi->fragments > 0 || wifi->truncated > 0) {
+                cli.printf("WiFi Fragments: %lu (%lu messages reassembled, %lu incomplete, %lu truncated)\n",
+                           wifi->fragments, wifi->reassembled, wifi->incomplete, wifi->truncated);
+            }
+        }
+    }
+
+    if (links & COMM_LINK_BIT(COMM_BLE)) {
         cli.printf("BLE Name: %s\n", cfg.getBLEName().c_str());
+
+        const BLELinkStats* ble = comm.getBLEStats();
+        if (ble) {
+            static const char* stateNames[] = {"Off", "Advertising", "Connected", "Restarting advertising"};
+            static const char* profileNames[] = {"none", "low latency", "low power"};
+            cli.printf("BLE State: %s\n", stateNames[ble->state]);
+            cli.printf("BLE Profile: %s (%lu parameter updates)\n",
+                       profileNames[ble->activeProfile], ble->paramUpdates);
+            cli.printf("BLE Connections: %lu, Disconnects: %lu, Advertising starts: %lu\n",
+                       ble->connections, ble->disconnects, ble->advertisingStarts);
+            unsigned long connectedMs = ble->connectedTotal;
+            if (ble->state == BLE_STATE_CONNECTED) {
+                connectedMs += millis() - ble->connectedSince;
+            }
+            cli.printf("BLE Connected time: %lu s\n", connectedMs / 1000);
+            cli.printf("BLE MTU: %d\n", ble->mtu);
+            cli.printf("BLE Writes: %lu (%lu fragments, %lu reassembled, %lu errors)\n",
+                       ble->writes, ble->fragments, ble->reassembled, ble->reassemblyErrors);
+            cli.printf("BLE Feedback notifications: %lu\n", ble->feedbackSent);
+
+            const FrameDecompressor* lz = comm.getBLEDecompressor();
+            if (lz && (lz->getStats().frames > 0 || lz->getStats().errors > 0)) {
+                const CompressionStats& cs = lz->getStats();
+                cli.printf("BLE Compression: %lu frames, ratio %.2f, %lu errors\n", cs.frames, lz->getRatio(), cs.errors);
+                cli.printf("BLE Decompression: %lu us avg, %lu us max\n", lz->getAverageMicros(), cs.maxMicros);
+            }
+        }
+    }
+
+    const TcpLinkStats* tcp = comm.getTcpStats();
+    if (tcp) {
+        cli.printf("TCP: %s on port %d\n", !tcp->listening ? "waiting for WiFi" :
+                   (tcp->clientConnected ? "client connected" : "listening"), cfg.getServerPort());
+        cli.printf("TCP Connections: %lu (%lu replaced), Disconnects: %lu\n",
+                   tcp->accepts, tcp->replaced, tcp->disconnects);
+        cli.printf("TCP Stalls: %lu, Peak buffered: %lu bytes, Errors: %lu framing, %lu decode\n",
+                   tcp->stalls, tcp->peakBuffered, tcp->protocolErrors, tcp->decodeErrors);
+        cli.printf("TCP Feedback: %lu messages\n", tcp->feedbackSent);
+    }
+
+    const SerialLinkStats* serial = comm.getSerialStats();
+    if (serial) {
+        cli.printf("Serial: %lu baud, %lu frames\n", cfg.getSerialBaud(), serial->frames);
+        cli.printf("Serial Errors: %lu COBS, %lu CRC, %lu decode, %lu overruns\n",
+                   serial->cobsErrors, serial->crcErrors, serial->decodeErrors, serial->overruns);
     }
 
     cli.printf("Display Theme: %d\n", cfg.getDisplayTheme());
     cli.printf("Brightness: %d\n", cfg.getBrightness());
     cli.printf("Server Port: %d\n", cfg.getServerPort());
     cli.printf("Idle Timeout: %d seconds\n", cfg.getIdleTimeout());
+    if (comm.getFirstDataTime() > 0) {
+        cli.printf("Boot to first data: %lu ms\n", comm.getFirstDataTime());
+    }
+
+    cli.printf("\nLinks:\n");
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        CommInterfaceType type = (CommInterfaceType)i;
+        const CommLinkHealth& health = comm.getHealth(type);
+        if (!health.enabled) {
+            continue;
+        }
+        cli.printf("  %s: %s%s\n", CommManager::getLinkName(type),
+                   !health.started ? "not started" : (comm.isLinkQuiet(type) ? "quiet" : "receiving"),
+                   type == comm.getActiveLink() ? ", active" : "");
+        if (health.started) {
+            cli.printf("    Updates: %lu (%lu delivered, %lu duplicates), Failovers: %lu\n",
+                       health.updates, health.delivered, health.duplicates, health.failovers);
+            cli.printf("    Throughput: %.1f frames/s, %.0f B/s, Period: %lu ms\n",
+                       health.frameRate, health.byteRate, health.period);
+        }
+    }
+
+    const FrameStats* frames = comm.getFrameStats();
+    if (frames) {
+        cli.printf("\nFrames:\n");
+        cli.printf("  Keyframes: %lu, Deltas: %lu\n", frames->keyframes, frames->deltas);
+        cli.printf("  Gaps: %lu (%lu frames missed), Stale: %lu, Coalesced: %lu\n",
+                   frames->gaps, frames->missedFrames, frames->staleFrames, frames->coalesced);
+        cli.printf("  Receive queue overflows: %lu\n", frames->overflows);
+        cli.printf("  Keyframe needed: %s\n", frames->keyframeNeeded ? "yes" : "no");
+    }
+
+    const CommFeedbackStats& feedback = comm.getFeedbackStats();
+    cli.printf("\nSender Feedback:\n");
+    cli.printf("  Sample period: %lu ms requested, %d ms configured%s\n", feedback.requestedInterval,
+               cfg.getSampleInterval(), feedback.overloaded ? " (overloaded)" : "");
+    cli.printf("  Overloads: %lu of %lu reports\n", feedback.overloads, feedback.reports);
+
+    HistoryStore& history = HistoryStore::getInstance();
+    cli.printf("\nHistory:\n");
+    cli.printf("  Samples: %lu, Duplicates dropped: %lu\n", history.getCount(), history.getDuplicates());
+
+    const LinkStats* link = comm.getLinkStats();
+    if (link && link->getExpected() > 0) {
+        cli.printf("\nLink Statistics:\n");
+        cli.printf("  Received: %lu of %lu (%.2f%% loss)\n",
+                   link->getReceived(), link->getExpected(), link->getLossRate());
+        cli.printf("  Duplicates: %lu, Reordered: %lu, Sender restarts: %lu\n",
+                   link->getDuplicates(), link->getReordered(), link->getRestarts());
+        if (link->hasTiming()) {
+            cli.printf("  Jitter: %.1f ms\n", link->getJitter());
+            cli.printf("  Latency: %.1f ms (max %.1f ms, above fastest path)\n",
+                       link->getLatency(), link->getMaxLatency());
+        }
+    }
 
     AlertThresholds thresh = cfg.getAlertThresholds();
     cli.printf("\nAlert Thresholds:\n");
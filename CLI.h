@@ -2,14 +2,24 @@
 #define CLI_H
 
 #include <Arduino.h>
-#include <vector>
 
 #define MAX_CMD_ARGS 10
 #define CMD_BUFFER_SIZE 128
+#define CLI_MAX_COMMANDS 40   // Fixed command table, filled during setup()
+
+// Binary frames share the UART with text commands: a 0x00 byte opens a
+// COBS-encoded frame and the next 0x00 closes it. Text never contains 0x00.
+#define CLI_FRAME_DELIMITER 0x00
+#define CLI_FRAME_BUFFER    1024
+#define CLI_RX_BUFFER       2048   // UART receive buffer for high baud rates
+#define CLI_FRAME_TIMEOUT   100    // ms without new bytes; an unterminated frame returns to text mode
 
 // Command handler function pointer type
 typedef void (*CommandHandler)(int argc, char* argv[]);
 
+// Receives each complete (still COBS-encoded) binary frame
+typedef void (*FrameHandler)(void* context, const uint8_t* frame, size_t length);
+
 // Command structure
 struct Command {
     const char* name;
@@ -27,6 +37,10 @@ public:
     // Register a new command
     void registerCommand(const char* name, const char* description, CommandHandler handler);
 
+    // Binary frames are discarded unless a handler is set
+    void setFrameHandler(FrameHandler handler, void* context);
+    uint32_t getFrameOverruns() const { return frameOverruns; }
+
     // Utility functions for commands
     void print(const char* str);
     void println(const char* str);
@@ -35,10 +49,23 @@ public:
 private:
     CLI();
 
-    std::vector<Command> commands;
+    Command commands[CLI_MAX_COMMANDS];
+    uint8_t commandCount;
     char cmdBuffer[CMD_BUFFER_SIZE];
     uint8_t cmdIndex;
 
+    // Binary frame demultiplexer
+    uint8_t frameBuffer[CLI_FRAME_BUFFER];
+    size_t frameLength;
+    bool inFrame;
+    bool frameOverrun;
+    unsigned long lastFrameByte;
+    uint32_t frameOverruns;
+    FrameHandler frameHandler;
+    void* frameContext;
+
+    void handleFrameByte(uint8_t c);
+
     void processCommand(char* cmdLine);
     void executeCommand(int argc, char* argv[]);
     void showHelp();
@@ -1,10 +1,18 @@
 #include "CLICommands.h"
 #include "Config.h"
+#include "CommManager.h"
+#include "SourceTable.h"
+#include "CounterRates.h"
+#include "MetricRegistry.h"
+#include "DataSnapshot.h"
+#include "FieldSchema.h"
+#include "StaticMemory.h"
+#include "MonitorWebServer.h"
 #include <WiFi.h>
 
 // WiFi scan results storage
 #define MAX_SCAN_RESULTS 20
-static String scanResults[MAX_SCAN_RESULTS];
+static char scanResults[MAX_SCAN_RESULTS][33];   // SSIDs are up to 32 bytes
 static int32_t scanRSSI[MAX_SCAN_RESULTS];
 static int scanCount = 0;
 
@@ -14,10 +22,24 @@ void registerCLICommands() {
     cli.registerCommand("setwifi", "Set WiFi credentials (setwifi \"SSID\" password)", cmdSetWiFi);
     cli.registerCommand("scanwifi", "Scan for WiFi networks", cmdScanWiFi);
     cli.registerCommand("selectwifi", "Select WiFi by index (selectwifi <index> <password>)", cmdSelectWiFi);
-    cli.registerCommand("setinterface", "Set communication interface (setinterface wifi|ble)", cmdSetInterface);
+    cli.registerCommand("setinterface", "Set preferred communication interface (setinterface wifi|ble|tcp|serial)", cmdSetInterface);
+    cli.registerCommand("setbaud", "Set serial baud rate (setbaud 115200-2000000)", cmdSetBaud);
+    cli.registerCommand("setlinks", "Run several interfaces with failover (setlinks wifi ble)", cmdSetLinks);
+    cli.registerCommand("setstaticip", "Set static IP (setstaticip <ip> <gateway> <subnet> [dns] | dhcp)", cmdSetStaticIP);
+    cli.registerCommand("setwififast", "Reuse the cached DHCP lease on reconnect (setwififast on|off)", cmdSetWiFiFast);
+    cli.registerCommand("setjitterbuffer", "Smooth bursty WiFi delivery with a playout delay (setjitterbuffer on|off)", cmdSetJitterBuffer);
+    cli.registerCommand("setmultihost", "Track every sending host for the grid theme (setmultihost on|off)", cmdSetMultiHost);
+    cli.registerCommand("setmulticast", "Receive frames from a multicast group (setmulticast <group> | off)", cmdSetMulticast);
+    cli.registerCommand("clearwificache", "Forget the cached access point and lease", cmdClearWiFiCache);
     cli.registerCommand("setblename", "Set BLE device name (setblename <name>)", cmdSetBLEName);
+    cli.registerCommand("setbleprofile", "Set BLE connection profile (setbleprofile auto|lowlatency|lowpower)", cmdSetBLEProfile);
     cli.registerCommand("setmdnsname", "Set mDNS hostname (setmdnsname <name>)", cmdSetMDNSName);
-    cli.registerCommand("settheme", "Set display theme (settheme 0-3)", cmdSetTheme);
+    cli.registerCommand("settheme", "Set display theme (settheme 0-5)", cmdSetTheme);
+    cli.registerCommand("sources", "List hosts tracked by the grid theme", cmdSources);
+    cli.registerCommand("data", "Show the latest data snapshot as JSON", cmdData);
+    cli.registerCommand("metrics", "List every registered metric and sensor", cmdMetrics);
+    cli.registerCommand("memmap", "Show the static memory map and heap use after setup", cmdMemMap);
+    cli.registerCommand("counters", "Show raw counters and their rates (counters [window ms])", cmdCounters);
     cli.registerCommand("setbrightness", "Set display brightness (setbrightness 0-255)", cmdSetBrightness);
     cli.registerCommand("setalert", "Set alert threshold (setalert cpu|mem|disk <value>)", cmdSetAlert);
     cli.registerCommand("setport", "Set server port (setport <port>)", cmdSetPort);
@@ -27,6 +49,7 @@ void registerCLICommands() {
     cli.registerCommand("setntpserver", "Set NTP server (setntpserver <server>)", cmdSetNTPServer);
     cli.registerCommand("settimezone", "Set timezone offset in seconds (settimezone <gmtOffset> [dstOffset])", cmdSetTimezone);
     cli.registerCommand("setidletimeout", "Set idle timeout in seconds (setidletimeout <seconds>)", cmdSetIdleTimeout);
+    cli.registerCommand("setrate", "Set the sample period asked of senders (setrate <ms>)", cmdSetRate);
 }
 
 void cmdSetWiFi(int argc, char* argv[]) {
@@ -86,7 +109,8 @@ void cmdScanWiFi(int argc, char* argv[]) {
     cli.println("-----  ----  --  ----------  ----");
 
     for (int i = 0; i < n && i < MAX_SCAN_RESULTS; i++) {
-        scanResults[i] = WiFi.SSID(i);
+        strncpy(scanResults[i], WiFi.SSID(i).c_str(), sizeof(scanResults[i]) - 1);
+        scanResults[i][sizeof(scanResults[i]) - 1] = '\0';
         scanRSSI[i] = WiFi.RSSI(i);
 
         char encType[10];
@@ -117,7 +141,7 @@ void cmdScanWiFi(int argc, char* argv[]) {
         // Format: [index] RSSI Ch Enc SSID
         char line[128];
         snprintf(line, sizeof(line), "[%2d]  %4d  %2d  %-10s  %s",
-                 i, scanRSSI[i], WiFi.channel(i), encType, scanResults[i].c_str());
+                 i, scanRSSI[i], WiFi.channel(i), encType, scanResults[i]);
         cli.println(line);
 
         scanCount++;
@@ -153,11 +177,11 @@ void cmdSelectWiFi(int argc, char* argv[]) {
     }
 
     Config& cfg = Config::getInstance();
-    cfg.setWiFiSSID(scanResults[index].c_str());
+    cfg.setWiFiSSID(scanResults[index]);
     cfg.setWiFiPassword(password);
 
     cli.printf("WiFi configured:\n");
-    cli.printf("  SSID: %s\n", scanResults[index].c_str());
+    cli.printf("  SSID: %s\n", scanResults[index]);
     cli.printf("  RSSI: %d dBm\n", scanRSSI[index]);
     cli.println("Restart required for changes to take effect");
 }
@@ -166,7 +190,7 @@ void cmdSetInterface(int argc, char* argv[]) {
     CLI& cli = CLI::getInstance();
 
     if (argc < 2) {
-        cli.println("Usage: setinterface wifi|ble");
+        cli.println("Usage: setinterface wifi|ble|tcp|serial");
         return;
     }
 
@@ -174,16 +198,89 @@ void cmdSetInterface(int argc, char* argv[]) {
 
     if (strcmp(argv[1], "wifi") == 0) {
         cfg.setCommInterface(COMM_WIFI);
-        cli.println("Interface set to WiFi");
+        cli.println("Preferred interface set to WiFi");
     } else if (strcmp(argv[1], "ble") == 0) {
         cfg.setCommInterface(COMM_BLE);
-        cli.println("Interface set to BLE");
+        cli.println("Preferred interface set to BLE");
+    } else if (strcmp(argv[1], "tcp") == 0) {
+        cfg.setCommInterface(COMM_TCP);
+        cli.println("Preferred interface set to TCP (over WiFi)");
+    } else if (strcmp(argv[1], "serial") == 0) {
+        cfg.setCommInterface(COMM_SERIAL);
+        cli.println("Preferred interface set to Serial");
     } else {
-        cli.println("Invalid interface. Use 'wifi' or 'ble'");
+        cli.println("Invalid interface. Use 'wifi', 'ble', 'tcp' or 'serial'");
         return;
     }
 
-    cli.println("Restart required for changes to take effect");
+    CommManager::getInstance().reconfigure();
+}
+
+void cmdSetBaud(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    static const uint32_t rates[] = {115200, 230400, 460800, 921600, 1000000, 1500000, 2000000};
+
+    if (argc < 2) {
+        cli.println("Usage: setbaud <rate>");
+        cli.println("Rates: 115200, 230400, 460800, 921600, 1000000, 1500000, 2000000");
+        cli.printf("Current baud rate: %lu\n", Config::getInstance().getSerialBaud());
+        return;
+    }
+
+    uint32_t baud = strtoul(argv[1], nullptr, 10);
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        if (rates[i] == baud) {
+            Config::getInstance().setSerialBaud(baud);
+            cli.printf("Baud rate set to: %lu\n", baud);
+            cli.println("Restart required for changes to take effect");
+            return;
+        }
+    }
+    cli.println("Unsupported baud rate");
+}
+
+void cmdSetLinks(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setlinks <wifi|ble|tcp|serial> [...]");
+        cli.println("Runs the listed interfaces together; data is taken from the");
+        cli.println("preferred interface (setinterface) and fails over to the others");
+        cli.println("Example: setlinks wifi ble");
+        return;
+    }
+
+    uint8_t links = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "wifi") == 0) {
+            links |= COMM_LINK_BIT(COMM_WIFI);
+        } else if (strcmp(argv[i], "ble") == 0) {
+            links |= COMM_LINK_BIT(COMM_BLE);
+        } else if (strcmp(argv[i], "tcp") == 0) {
+            links |= COMM_LINK_BIT(COMM_TCP);
+        } else if (strcmp(argv[i], "serial") == 0) {
+            links |= COMM_LINK_BIT(COMM_SERIAL);
+        } else {
+            cli.printf("Invalid interface: %s\n", argv[i]);
+            return;
+        }
+    }
+
+    Config& cfg = Config::getInstance();
+    uint8_t previous = cfg.getCommLinks();
+    cfg.setCommLinks(links);
+    CommManager::getInstance().reconfigure();
+
+    cli.print("Links:");
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        if (cfg.getCommLinks() & COMM_LINK_BIT(i)) {
+            cli.printf(" %s", CommManager::getLinkName((CommInterfaceType)i));
+        }
+    }
+    cli.println("");
+    if (previous & ~cfg.getCommLinks()) {
+        cli.println("Restart required to stop removed links");
+    }
 }
 
 void cmdSetBLEName(int argc, char* argv[]) {
@@ -199,6 +296,182 @@ void cmdSetBLEName(int argc, char* argv[]) {
     cli.println("Restart required for changes to take effect");
 }
 
+void cmdSetStaticIP(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    Config& cfg = Config::getInstance();
+    StaticIPConfig ipConfig = {0, 0, 0, 0};
+
+    if (argc == 2 && strcmp(argv[1], "dhcp") == 0) {
+        cfg.setStaticIP(ipConfig);
+        cli.println("Using DHCP. Restart to apply.");
+        return;
+    }
+
+    if (argc < 4) {
+        cli.println("Usage: setstaticip <ip> <gateway> <subnet> [dns]");
+        cli.println("       setstaticip dhcp");
+        cli.println("Example: setstaticip 192.168.1.50 192.168.1.1 255.255.255.0");
+        return;
+    }
+
+    IPAddress ip, gateway, subnet, dns;
+    if (!ip.fromString(argv[1]) || !gateway.fromString(argv[2]) || !subnet.fromString(argv[3])) {
+        cli.println("Invalid IP address");
+        return;
+    }
+    if (argc >= 5) {
+        if (!dns.fromString(argv[4])) {
+            cli.println("Invalid DNS address");
+            return;
+        }
+    } else {
+        dns = gateway;
+    }
+
+    ipConfig.ip = (uint32_t)ip;
+    ipConfig.gateway = (uint32_t)gateway;
+    ipConfig.subnet = (uint32_t)subnet;
+    ipConfig.dns = (uint32_t)dns;
+    cfg.setStaticIP(ipConfig);
+
+    cli.printf("Static IP set to: %s. Restart to apply.\n", argv[1]);
+}
+
+void cmdSetWiFiFast(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setwififast on|off");
+        cli.println("  on  - Reuse the last DHCP lease when reconnecting to the cached AP");
+        cli.println("  off - Always request a lease from DHCP (default)");
+        return;
+    }
+
+    Config& cfg = Config::getInstance();
+
+    if (strcmp(argv[1], "on") == 0) {
+        cfg.setWiFiFastLease(true);
+    } else if (strcmp(argv[1], "off") == 0) {
+        cfg.setWiFiFastLease(false);
+    } else {
+        cli.println("Invalid option. Use 'on' or 'off'");
+        return;
+    }
+
+    cli.printf("WiFi lease reuse: %s\n", argv[1]);
+}
+
+void cmdSetJitterBuffer(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setjitterbuffer on|off");
+        cli.printf("  on  - Hold timestamped WiFi frames %d-%d ms and release them evenly\n",
+                   PLAYOUT_MIN_DELAY, PLAYOUT_MAX_DELAY);
+        cli.println("  off - Apply frames as they arrive (default)");
+        return;
+    }
+
+    Config& cfg = Config::getInstance();
+
+    if (strcmp(argv[1], "on") == 0) {
+        cfg.setJitterBuffer(true);
+    } else if (strcmp(argv[1], "off") == 0) {
+        cfg.setJitterBuffer(false);
+    } else {
+        cli.println("Invalid option. Use 'on' or 'off'");
+        return;
+    }
+
+    cli.printf("Jitter buffer: %s\n", argv[1]);
+}
+
+void cmdSetMultiHost(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setmultihost on|off");
+        cli.printf("  on  - Keep up to %d hosts apart; the grid theme shows them all\n", SOURCE_TABLE_SIZE);
+        cli.println("  off - Follow a single stream (default)");
+        return;
+    }
+
+    Config& cfg = Config::getInstance();
+
+    if (strcmp(argv[1], "on") == 0) {
+        cfg.setMultiHost(true);
+    } else if (strcmp(argv[1], "off") == 0) {
+        cfg.setMultiHost(false);
+    } else {
+        cli.println("Invalid option. Use 'on' or 'off'");
+        return;
+    }
+
+    cli.printf("Multi-host mode: %s\n", argv[1]);
+}
+
+void cmdSetMulticast(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setmulticast <group>");
+        cli.println("       setmulticast off");
+        cli.println("Example: setmulticast 239.1.2.3");
+        return;
+    }
+
+    Config& cfg = Config::getInstance();
+
+    if (strcmp(argv[1], "off") == 0) {
+        cfg.setMulticastGroup(0);
+        cli.println("Multicast off. Restart to apply.");
+        return;
+    }
+
+    IPAddress group;
+    if (!group.fromString(argv[1]) || !WiFiComm::isMulticastAddress(group)) {
+        cli.println("Invalid group. Use an address in 224.0.0.0-239.255.255.255");
+        return;
+    }
+
+    cfg.setMulticastGroup((uint32_t)group);
+    cli.printf("Multicast group set to: %s (port %d). Restart to apply.\n", argv[1], cfg.getServerPort());
+}
+
+void cmdClearWiFiCache(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    Config::getInstance().clearWiFiCache();
+    cli.println("WiFi cache cleared. Next connect will scan for the AP.");
+}
+
+void cmdSetBLEProfile(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setbleprofile auto|lowlatency|lowpower");
+        cli.println("  auto       - Low latency while data flows, low power when idle");
+        cli.println("  lowlatency - 7.5-15 ms connection interval for live graphs");
+        cli.println("  lowpower   - 100-200 ms interval with slave latency");
+        return;
+    }
+
+    Config& cfg = Config::getInstance();
+
+    if (strcmp(argv[1], "auto") == 0) {
+        cfg.setBLEProfile(BLE_PROFILE_AUTO);
+    } else if (strcmp(argv[1], "lowlatency") == 0) {
+        cfg.setBLEProfile(BLE_PROFILE_LOW_LATENCY);
+    } else if (strcmp(argv[1], "lowpower") == 0) {
+        cfg.setBLEProfile(BLE_PROFILE_LOW_POWER);
+    } else {
+        cli.println("Invalid profile. Use 'auto', 'lowlatency' or 'lowpower'");
+        return;
+    }
+
+    cli.printf("BLE profile set to: %s\n", argv[1]);
+}
+
 void cmdSetMDNSName(int argc, char* argv[]) {
     CLI& cli = CLI::getInstance();
 
@@ -212,13 +485,11 @@ void cmdSetMDNSName(int argc, char* argv[]) {
     }
 
     // Validate mDNS name (only alphanumeric and hyphens, lowercase)
-    String name = String(argv[1]);
-    name.toLowerCase();
-
+    char* name = argv[1];
     bool valid = true;
-    for (size_t i = 0; i < name.length(); i++) {
-        char c = name.charAt(i);
-        if (!isalnum(c) && c != '-') {
+    for (char* c = name; *c; c++) {
+        *c = tolower(*c);
+        if (!isalnum(*c) && *c != '-') {
             valid = false;
             break;
         }
@@ -229,8 +500,8 @@ void cmdSetMDNSName(int argc, char* argv[]) {
         return;
     }
 
-    Config::getInstance().setMDNSName(name.c_str());
-    cli.printf("mDNS name set to: %s.local\n", name.c_str());
+    Config::getInstance().setMDNSName(name);
+    cli.printf("mDNS name set to: %s.local\n", name);
     cli.println("Restart required for changes to take effect");
 }
 
@@ -238,17 +509,19 @@ void cmdSetTheme(int argc, char* argv[]) {
     CLI& cli = CLI::getInstance();
 
     if (argc < 2) {
-        cli.println("Usage: settheme <0-3>");
+        cli.println("Usage: settheme <0-5>");
         cli.println("  0 - Default");
         cli.println("  1 - Minimal");
         cli.println("  2 - Graph");
         cli.println("  3 - Compact");
+        cli.println("  4 - Grid (one tile per host)");
+        cli.println("  5 - Sensors (every metric)");
         return;
     }
 
     int theme = atoi(argv[1]);
-    if (theme < 0 || theme > 3) {
-        cli.println("Theme must be between 0 and 3");
+    if (theme < 0 || theme > 5) {
+        cli.println("Theme must be between 0 and 5");
         return;
     }
 
@@ -256,6 +529,96 @@ void cmdSetTheme(int argc, char* argv[]) {
     cli.printf("Display theme set to: %d\n", theme);
 }
 
+void cmdSources(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    SourceTable& sources = SourceTable::getInstance();
+    unsigned long now = millis();
+
+    if (!Config::getInstance().isMultiHost()) {
+        cli.println("Multi-host mode is off (setmultihost on turns it on)");
+    }
+    cli.printf("Hosts: %d of %d, Evictions: %lu, Stale frames: %lu\n", sources.getCount(),
+               SOURCE_TABLE_SIZE, sources.getEvictions(), sources.getStaleFrames());
+
+    for (int i = 0; i < sources.getCount(); i++) {
+        const SourceEntry& entry = sources.getEntry(i);
+        cli.printf("  %2d %-23s %-6s %-7s %4lus ago  %lu frames  CPU %.0f%%  MEM %.0f%%\n", i, entry.id,
+                   CommManager::getLinkName(entry.link), sources.isLive(i, now) ? "live" : "offline",
+                   (now - entry.lastSeen) / 1000, entry.frames, entry.data.cpuUsage, entry.data.memoryPercent);
+    }
+}
+
+void cmdCounters(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    CounterRates& counters = CounterRates::getInstance();
+
+    uint32_t window = argc >= 2 ? strtoul(argv[1], nullptr, 10) : COUNTER_RATE_WINDOW;
+    const CounterStats& stats = counters.getStats();
+    cli.printf("Samples: %lu, Late: %lu, Wraps: %lu, Resets: %lu\n", stats.samples, stats.late,
+               stats.wraps, stats.resets);
+
+    bool any = false;
+    for (uint8_t id = 0; id < COUNTER_COUNT; id++) {
+        if (!counters.hasCounter(id)) {
+            continue;
+        }
+        any = true;
+        float rate;
+        uint32_t span;
+        if (counters.getRate(id, window, rate, span)) {
+            cli.printf("  %-12s %16.0f  %12.1f /s over %lu ms\n", CounterRates::getName(id),
+                       (double)counters.getTotal(id), rate, span);
+        } else {
+            cli.printf("  %-12s %16.0f  (one sample)\n", CounterRates::getName(id), (double)counters.getTotal(id));
+        }
+    }
+    if (!any) {
+        cli.println("No counters received (monitor_client.py --counters sends them)");
+    }
+}
+
+void cmdData(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+
+    // Written in place from the snapshot, again only when it has changed
+    static char json[FIELD_SCHEMA_JSON_MAX];
+    static uint32_t version = 0;
+    if (snapshot.getVersion() == 0) {
+        cli.println("No data received yet");
+        return;
+    }
+    if (snapshot.getVersion() != version) {
+        version = snapshot.view([](const SystemData& data) {
+            FieldSchema::writeJSON(data, json, sizeof(json));
+        });
+    }
+
+    cli.printf("Snapshot version: %lu, read retries: %lu\n", version, snapshot.getRetries());
+    cli.print("{");
+    cli.print(json);
+    cli.println("}");
+}
+
+void cmdMetrics(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    MetricRegistry& metrics = MetricRegistry::getInstance();
+    unsigned long now = millis();
+
+    cli.printf("Metrics: %u/%u (%u built in), hash seed 0x%08lx, rehashes: %lu, rejected: %lu\n",
+               metrics.getCount(), METRIC_MAX, metrics.getBuiltinCount(), metrics.getSeed(),
+               metrics.getRehashes(), metrics.getRejected());
+    for (uint8_t id = 0; id < metrics.getCount(); id++) {
+        const MetricInfo& info = metrics.getInfo(id);
+        if (info.updated == 0) {
+            cli.printf("  %2u %-23s %12s\n", id, info.name, "--");
+            continue;
+        }
+        cli.printf("  %2u %-23s %12.2f %-7s %6lus ago%s\n", id, info.name, metrics.getValue(id), info.unit,
+                   (now - info.updated) / 1000, metrics.isStale(id, now) ? " (stale)" : "");
+    }
+}
+
 void cmdSetBrightness(int argc, char* argv[]) {
     CLI& cli = CLI::getInstance();
 
@@ -482,3 +845,62 @@ void cmdSetIdleTimeout(int argc, char* argv[]) {
         cli.printf("Idle timeout set to: %d seconds\n", timeout);
     }
 }
+
+void cmdSetRate(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+
+    if (argc < 2) {
+        cli.println("Usage: setrate <ms>");
+        cli.println("Sample period senders are asked for; stretched while the display is overloaded");
+        cli.printf("Range: %d-%d ms\n", SAMPLE_INTERVAL_MIN, SAMPLE_INTERVAL_MAX);
+        cli.printf("Current sample period: %d ms\n", Config::getInstance().getSampleInterval());
+        return;
+    }
+
+    int ms = atoi(argv[1]);
+    if (ms < SAMPLE_INTERVAL_MIN || ms > SAMPLE_INTERVAL_MAX) {
+        cli.printf("Sample period must be between %d and %d ms\n", SAMPLE_INTERVAL_MIN, SAMPLE_INTERVAL_MAX);
+        return;
+    }
+
+    Config::getInstance().setSampleInterval((uint16_t)ms);
+    cli.printf("Sample period set to: %d ms (senders follow within a few seconds)\n", ms);
+}
+
+void cmdMemMap(int argc, char* argv[]) {
+    CLI& cli = CLI::getInstance();
+    cli.printf("Static memory map (STATIC_MEMORY=%d):\n", STATIC_MEMORY);
+    for (uint8_t i = 0; i < StaticMemory::getRegionCount(); i++) {
+        const MemoryRegion& region = StaticMemory::getRegions()[i];
+        cli.printf("  %-22s %7u bytes\n", region.name, (unsigned)region.size);
+    }
+    cli.printf("  %-22s %7u of %u bytes budget (%u%%), %u free\n", "Total", (unsigned)StaticMemory::getTotal(),
+               (unsigned)STATIC_MEMORY_BUDGET, (unsigned)(StaticMemory::getTotal() * 100 / STATIC_MEMORY_BUDGET),
+               (unsigned)(STATIC_MEMORY_BUDGET - StaticMemory::getTotal()));
+    cli.printf("Budget: %u bytes of DRAM for statics, less %u for the core and %u kept for WiFi/BLE heap\n",
+               (unsigned)DRAM_STATIC_SEGMENT, (unsigned)CORE_STATIC_SIZE, (unsigned)STACK_HEAP_RESERVE);
+    cli.printf("Web pages: %d bytes, truncated %lu times\n", WEB_PAGE_SIZE,
+               MonitorWebServer::getInstance().getTruncatedPages());
+
+#if STATIC_MEMORY
+    StaticMemory& memory = StaticMemory::getInstance();
+    cli.printf("JSON arenas: %d x %d bytes, peak %u, all busy %lu times\n", JSON_ARENA_COUNT, JSON_ARENA_SIZE,
+               (unsigned)memory.getArenaPeak(), memory.getArenaMisses());
+    cli.printf("JSON frames dropped: %lu over %d bytes, %lu out of arena room\n", memory.getArenaOversize(),
+               JSON_FRAME_MAX, memory.getArenaOverflows());
+
+    HeapCallStats heap = memory.getHeapCalls();
+    if (heap.calls == 0) {
+        cli.printf("Heap calls after setup (%s): none\n", HEAP_CALLS_COUNTED);
+    } else {
+        cli.printf("Heap calls after setup (%s): %lu, %lu bytes, largest %lu, first %lus after boot\n",
+                   HEAP_CALLS_COUNTED, heap.calls, heap.bytes, heap.largest, heap.firstAt / 1000);
+    }
+    cli.printf("Heap held since setup (every allocator): %+ld blocks, %+ld bytes\n", (long)heap.blocks,
+               (long)heap.heldBytes);
+#else
+    cli.println("Heap calls after setup: not counted (build with STATIC_MEMORY 1)");
+#endif
+    cli.printf("Heap: %lu free, %lu lowest, %lu largest block\n", ESP.getFreeHeap(), ESP.getMinFreeHeap(),
+               ESP.getMaxAllocHeap());
+}
@@ -11,9 +11,18 @@ void cmdSetWiFi(int argc, char* argv[]);
 void cmdScanWiFi(int argc, char* argv[]);
 void cmdSelectWiFi(int argc, char* argv[]);
 void cmdSetInterface(int argc, char* argv[]);
+void cmdSetLinks(int argc, char* argv[]);
+void cmdSetBaud(int argc, char* argv[]);
+void cmdSetStaticIP(int argc, char* argv[]);
+void cmdSetWiFiFast(int argc, char* argv[]);
+void cmdSetJitterBuffer(int argc, char* argv[]);
+void cmdSetMultiHost(int argc, char* argv[]);
+void cmdSetMulticast(int argc, char* argv[]);
+void cmdClearWiFiCache(int argc, char* argv[]);
 
 // BLE commands
 void cmdSetBLEName(int argc, char* argv[]);
+void cmdSetBLEProfile(int argc, char* argv[]);
 
 // mDNS commands
 void cmdSetMDNSName(int argc, char* argv[]);
@@ -21,6 +30,10 @@ void cmdSetMDNSName(int argc, char* argv[]);
 // Display commands
 void cmdSetTheme(int argc, char* argv[]);
 void cmdSetBrightness(int argc, char* argv[]);
+void cmdSources(int argc, char* argv[]);
+void cmdCounters(int argc, char* argv[]);
+void cmdMetrics(int argc, char* argv[]);
+void cmdData(int argc, char* argv[]);
 
 // Alert commands
 void cmdSetAlert(int argc, char* argv[]);
@@ -30,6 +43,7 @@ void cmdSetPort(int argc, char* argv[]);
 
 // Idle timeout commands
 void cmdSetIdleTimeout(int argc, char* argv[]);
+void cmdSetRate(int argc, char* argv[]);
 
 // Date/Time commands
 void cmdSetDateTime(int argc, char* argv[]);
@@ -40,4 +54,7 @@ void cmdSyncNTP(int argc, char* argv[]);
 void cmdSetNTPServer(int argc, char* argv[]);
 void cmdSetTimezone(int argc, char* argv[]);
 
+// Memory commands
+void cmdMemMap(int argc, char* argv[]);
+
 #endif
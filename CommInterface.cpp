@@ -1,69 +1,496 @@
 #include "CommInterface.h"
+#include "SourceTable.h"
+#include "FieldSchema.h"
+#include "StaticMemory.h"
 #include <ArduinoJson.h>
 
+static uint32_t readU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t readU64(const uint8_t* p) {
+    return (uint64_t)readU32(p) | ((uint64_t)readU32(p + 4) << 32);
+}
+
+static void writeU16(uint8_t* p, uint32_t value) {
+    // Saturates rather than wrapping, so a long period never reads as a short one
+    uint16_t v = value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static int16_t readI16(const uint8_t* p) {
+    return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+CommInterface::CommInterface(CommInterfaceType type) : type(type), lastSeq(0), haveSeq(false),
+                                                       lastApplied(0), linkCallback(nullptr), pendingCount(0) {
+}
+
 bool CommInterface::parseJSON(const char* json, SystemData& data) {
+    TelemetryFrame frame;
+    if (!decodeJSON(json, strlen(json), frame)) {
+        return false;
+    }
+    return applyFrame(frame, data);
+}
+
+bool CommInterface::decodePayload(const uint8_t* payload, size_t length, TelemetryFrame& frame) {
+    if (length > 0 && payload[0] == FRAME_BINARY_MAGIC) {
+        return decodeBinary(payload, length, frame);
+    }
+    return decodeJSON((const char*)payload, length, frame);
+}
+
+bool CommInterface::decodeBinary(const uint8_t* payload, size_t length, TelemetryFrame& frame) {
+    frame.receivedAt = millis();
+    frame.length = length;
+
+    if (length < FRAME_BINARY_HEADER) {
+        Serial.println("Binary frame too short");
+        return false;
+    }
+
+    uint8_t flags = payload[1];
+    frame.keyframe = (flags & FRAME_FLAG_KEYFRAME) != 0;
+    frame.partial = !frame.keyframe && (flags & FRAME_FLAG_PARTIAL) != 0;
+    frame.hasSeq = (flags & FRAME_FLAG_SEQ) != 0;
+    frame.seq = readU32(payload + 2);
+    frame.hasSendTime = (flags & FRAME_FLAG_TS) != 0;
+    frame.sendTime = readU32(payload + 6);
+    uint32_t fields = readU32(payload + 10) & FIELD_ALL;
+
+    const uint8_t* p = payload + FRAME_BINARY_HEADER;
+    const uint8_t* end = payload + length;
+
+    if (flags & FRAME_FLAG_HOST) {
+        if (end - p < 1 || end - p < 1 + p[0]) {
+            Serial.println("Binary frame truncated");
+            return false;
+        }
+        size_t n = p[0] < FRAME_SOURCE_SIZE - 1 ? p[0] : FRAME_SOURCE_SIZE - 1;
+        memcpy(frame.source, p + 1, n);
+        frame.source[n] = '\0';
+        p += 1 + p[0];
+    }
+
+    if (!FieldSchema::readBinary(p, end, fields, frame.data)) {
+        Serial.println("Binary frame truncated");
+        return false;
+    }
+
+    if ((flags & FRAME_FLAG_BATCH) && !decodeBatch(p, end, frame.batch)) {
+        Serial.println("Binary sample batch invalid");
+        return false;
+    }
+
+    if ((flags & FRAME_FLAG_COUNTERS) && !decodeCounters(p, end, frame.counters)) {
+        Serial.println("Binary counters truncated");
+        return false;
+    }
+
+    frame.fields = frame.keyframe ? FIELD_ALL : fields;
+    return true;
+}
+
+bool CommInterface::decodeBatch(const uint8_t*& p, const uint8_t* end, SampleBatch& batch) {
+    if (end - p < 2) {
+        return false;
+    }
+
+    uint8_t count = p[0];
+    uint8_t mask = p[1];
+    p += 2;
+
+    // Samples past HISTORY_BATCH_MAX are read over but not kept
+    for (uint8_t i = 0; i < count; i++) {
+        if (end - p < 2) {
+            return false;
+        }
+        bool keep = i < HISTORY_BATCH_MAX;
+        if (keep) {
+            batch.offsetMs[i] = readI16(p);
+        }
+        p += 2;
+
+        // Every mask bit takes a slot; bits past the known fields are skipped
+        for (uint8_t field = 0; field < 8; field++) {
+            if (!(mask & (1 << field))) {
+                continue;
+            }
+            if (end - p < 4) {
+                return false;
+            }
+            if (keep && field < HISTORY_FIELD_COUNT) {
+                uint32_t raw = readU32(p);
+                float value;
+                memcpy(&value, &raw, sizeof(float));
+                batch.set(i, field, value);
+            }
+            p += 4;
+        }
+    }
+
+    batch.count = count < HISTORY_BATCH_MAX ? count : HISTORY_BATCH_MAX;
+    batch.fields = mask & ((1 << HISTORY_FIELD_COUNT) - 1);
+    return true;
+}
+
+bool CommInterface::decodeCounters(const uint8_t*& p, const uint8_t* end, CounterSample& counters) {
+    if (end - p < 1) {
+        return false;
+    }
+
+    uint8_t mask = p[0];
+    p++;
+
+    // As in a batch, bits past the known counters still take a slot
+    for (uint8_t id = 0; id < 8; id++) {
+        if (!(mask & (1 << id))) {
+            continue;
+        }
+        if (end - p < 8) {
+            return false;
+        }
+        if (id < COUNTER_COUNT) {
+            counters.values[id] = readU64(p);
+        }
+        p += 8;
+    }
+
+    counters.mask = mask & ((1 << COUNTER_COUNT) - 1);
+    return true;
+}
+
+bool CommInterface::decodeJSON(const char* json, size_t length, TelemetryFrame& frame) {
+    frame.receivedAt = millis();
+    frame.length = length;
+
+#if STATIC_MEMORY
+    // A fixed arena per concurrent decode instead of the heap. Arenas are
+    // sized for JSON_FRAME_MAX; longer frames (fragmented UDP) must be binary.
+    if (length > JSON_FRAME_MAX) {
+        StaticMemory::getInstance().noteOversize();
+        return false;
+    }
+    JsonArenaLease arena;
+    if (!arena) {
+        return false;
+    }
+    JsonDocument doc(arena.get());
+#else
     JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, json);
+#endif
+    DeserializationError error = deserializeJson(doc, json, length);
 
     if (error) {
+#if STATIC_MEMORY
+        if (error == DeserializationError::NoMemory) {
+            StaticMemory::getInstance().noteOverflow();
+        }
+#endif
         Serial.print("JSON parse error: ");
         Serial.println(error.c_str());
         return false;
     }
 
-    // Parse CPU data
-    if (!doc["cpu"].isNull()) {
-        data.cpuUsage = doc["cpu"]["usage"] | 0.0f;
-        data.cpuTemp = doc["cpu"]["temp"] | 0.0f;
-        const char* name = doc["cpu"]["name"];
-        if (name) {
-            strncpy(data.cpuName, name, sizeof(data.cpuName) - 1);
-        }
+    // Frame header: packets without "type" are legacy full snapshots
+    const char* type = doc["type"];
+    frame.keyframe = !(type && strcmp(type, "delta") == 0);
+    frame.partial = !frame.keyframe && doc["partial"].as<bool>();
+    if (!doc["seq"].isNull()) {
+        frame.hasSeq = true;
+        frame.seq = doc["seq"].as<uint32_t>();
     }
+    if (!doc["ts"].isNull()) {
+        frame.hasSendTime = true;
+        frame.sendTime = doc["ts"].as<uint32_t>();
+    }
+    const char* host = doc["host"];
+    if (host) {
+        strncpy(frame.source, host, sizeof(frame.source) - 1);
+        frame.source[sizeof(frame.source) - 1] = '\0';
+    }
+
+    // Every SystemData field, one pass over SYSTEM_DATA_FIELDS
+    uint32_t fields = FieldSchema::readJSON(doc.as<JsonVariantConst>(), frame.data);
 
-    // Parse Memory data
-    if (!doc["memory"].isNull()) {
-        data.memoryUsed = doc["memory"]["used"] | 0.0f;
-        data.memoryTotal = doc["memory"]["total"] | 0.0f;
-        data.memoryPercent = doc["memory"]["percent"] | 0.0f;
+    // Raw counters: {"net_tx": bytes, ...}; the device derives the rates
+    JsonObjectConst counters = doc["counters"];
+    for (JsonPairConst counter : counters) {
+        int id = CounterRates::idFromName(counter.key().c_str());
+        if (id >= 0) {
+            frame.counters.values[id] = counter.value().as<uint64_t>();
+            frame.counters.mask |= 1 << id;
+        }
     }
 
-    // Parse Disk data
-    if (!doc["disk"].isNull()) {
-        data.diskUsed = doc["disk"]["used"] | 0.0f;
-        data.diskTotal = doc["disk"]["total"] | 0.0f;
-        data.diskPercent = doc["disk"]["percent"] | 0.0f;
+    // Extra sensors: {"fan.cpu": 1200, "psu.12v": {"value": 12050, "unit": "V", "scale": 0.001}}
+    JsonObjectConst sensors = doc["sensors"];
+    for (JsonPairConst sensor : sensors) {
+        const char* name = sensor.key().c_str();
+        if (frame.sensorCount >= FRAME_SENSOR_MAX || strlen(name) >= METRIC_NAME_SIZE) {
+            continue;
+        }
+        JsonVariantConst value = sensor.value();
+        FrameSensor& out = frame.sensors[frame.sensorCount];
+        out.unit[0] = '\0';
+        out.scale = 0.0f;
+        if (value.is<JsonObjectConst>()) {
+            const char* unit = value["unit"];
+            if (unit) {
+                strncpy(out.unit, unit, sizeof(out.unit) - 1);
+                out.unit[sizeof(out.unit) - 1] = '\0';
+            }
+            if (!value["scale"].isNull()) {
+                out.scale = value["scale"].as<float>();
+            }
+            value = value["value"];
+        }
+        if (value.isNull()) {
+            continue;
+        }
+        strcpy(out.name, name);
+        out.value = value.as<float>();
+        frame.sensorCount++;
     }
 
-    // Parse Network data
-    if (!doc["network"].isNull()) {
-        data.networkUpload = doc["network"]["upload"] | 0.0f;
-        data.networkDownload = doc["network"]["download"] | 0.0f;
+    // Batched history: {"fields": ["cpu", ...], "data": [[offsetMs, v, ...], ...]}
+    JsonVariantConst samples = doc["samples"];
+    if (!samples.isNull()) {
+        JsonArrayConst names = samples["fields"];
+        JsonArrayConst rows = samples["data"];
+        int columns[HISTORY_FIELD_COUNT];
+        uint8_t columnCount = 0;
+        SampleBatch& batch = frame.batch;
+
+        batch.fields = 0;
+        for (JsonVariantConst name : names) {
+            const char* fieldName = name.as<const char*>();
+            int field = fieldName ? HistoryStore::fieldFromName(fieldName) : -1;
+            if (columnCount == HISTORY_FIELD_COUNT) {
+                break;
+            }
+            columns[columnCount++] = field;
+            if (field >= 0) {
+                batch.fields |= 1 << field;
+            }
+        }
+
+        batch.count = 0;
+        for (JsonArrayConst row : rows) {
+            if (batch.count >= HISTORY_BATCH_MAX) {
+                break;
+            }
+            batch.offsetMs[batch.count] = row[0].as<int16_t>();
+            for (uint8_t c = 0; c < columnCount; c++) {
+                if (columns[c] >= 0) {
+                    batch.set(batch.count, columns[c], row[c + 1].as<float>());
+                }
+            }
+            batch.count++;
+        }
     }
 
-    // Parse GPU data (optional)
-    if (!doc["gpu"].isNull()) {
-        data.gpuUsage = doc["gpu"]["usage"] | 0.0f;
-        data.gpuTemp = doc["gpu"]["temp"] | 0.0f;
+    // A keyframe defines every field; anything it omits is reset to default
+    frame.fields = frame.keyframe ? FIELD_ALL : fields;
+    return true;
+}
+
+void CommInterface::setSourceAddress(TelemetryFrame& frame, const IPAddress& address) {
+    if (frame.source[0] == '\0') {
+        snprintf(frame.source, sizeof(frame.source), "%u.%u.%u.%u",
+                 address[0], address[1], address[2], address[3]);
     }
+}
 
-    // Parse additional temperature data
-    if (!doc["temperatures"].isNull()) {
-        data.motherboardTemp = doc["temperatures"]["motherboard"] | 0.0f;
+bool CommInterface::applyFrame(const TelemetryFrame& frame, SystemData& data) {
+    frameStats.frames++;
+    frameStats.bytes += frame.length;
 
-        // Get first disk temperature if available
-        if (!doc["temperatures"]["disks"].isNull() && doc["temperatures"]["disks"].is<JsonArray>()) {
-            JsonArray disks = doc["temperatures"]["disks"];
-            if (disks.size() > 0) {
-                data.diskTemp = disks[0]["temp"] | 0.0f;
-                const char* diskName = disks[0]["name"];
-                if (diskName) {
-                    strncpy(data.diskName, diskName, sizeof(data.diskName) - 1);
-                }
+    // Several hosts share the link: each keeps its sequence and field state
+    // in the source table. The host in the first slot is also followed as
+    // the link's own stream, which the other themes, the link statistics and
+    // the history show; the rest leave this link's data untouched.
+    if (Config::getInstance().isMultiHost()) {
+        int slot = SourceTable::getInstance().apply(frame, type);
+        if (slot < 0) {
+            frameStats.staleFrames++;
+            return false;
+        }
+        if (slot != 0) {
+            if (frame.keyframe) {
+                frameStats.keyframes++;
+            } else {
+                frameStats.deltas++;
             }
+            return false;
+        }
+    }
+
+    // What gets applied is decided here. LinkStats sees every arrival, stale
+    // ones included, and starts a new epoch only on the restarts taken here.
+    int32_t diff = 0;
+    bool restarted = false;
+    bool stale = false;
+    if (frame.hasSeq && haveSeq) {
+        diff = (int32_t)(frame.seq - lastSeq);
+
+        // Anything older than what we hold would roll fields back. Only a
+        // keyframe far behind, or after a quiet spell, is a sender restart;
+        // a late one over UDP is just stale.
+        if (diff <= 0) {
+            restarted = frame.keyframe &&
+                (diff < -FRAME_RESTART_GAP || frame.receivedAt - lastApplied > FRAME_RESTART_QUIET);
+            stale = !restarted;
         }
     }
 
-    data.timestamp = millis();
+    // Network figures are taken at arrival, before any jitter buffer delay
+    linkStats.record(frame.hasSeq, frame.seq, restarted, frame.hasSendTime, frame.sendTime,
+                     frame.receivedAt - frame.playoutDelay);
+
+    if (stale) {
+        frameStats.staleFrames++;
+        return false;
+    }
+
+    // Frames folded into this one by the receive task weren't lost
+    int32_t missed = diff - 1 - frame.coalesced;
+    if (missed > 0) {
+        frameStats.gaps++;
+        frameStats.missedFrames += missed;
+        if (!frame.keyframe) {
+            // The missing deltas may have changed fields this one doesn't carry
+            frameStats.keyframeNeeded = true;
+        }
+    }
+
+    if (frame.hasSeq) {
+        lastSeq = frame.seq;
+        haveSeq = true;
+    }
+    lastApplied = frame.receivedAt;
+
+    if (frame.keyframe) {
+        data = frame.data;
+        frameStats.keyframes++;
+        frameStats.keyframeNeeded = false;
+    } else {
+        data.merge(frame.data, frame.fields);
+        frameStats.deltas++;
+    }
+
+    // Rates from raw counters replace any averaged ones the frame carried
+    uint32_t derived = 0;
+    if (frame.counters.mask) {
+        CounterRates& rates = CounterRates::getInstance();
+        rates.record(frame.counters, frame.hasSendTime ? frame.sendTime : frame.receivedAt);
+        derived = rates.fill(data);
+    }
+
+    data.timestamp = frame.receivedAt;
+    uint32_t fresh = (frame.partial ? frame.fields : FIELD_ALL) | derived;
+    data.touch(fresh, frame.fields | derived, frame.receivedAt);
+    updateMetrics(frame, data, fresh);
+    recordHistory(frame, data);
     return true;
 }
+
+void CommInterface::updateMetrics(const TelemetryFrame& frame, const SystemData& data, uint32_t fresh) {
+    MetricRegistry& metrics = MetricRegistry::getInstance();
+    metrics.updateFrom(data, fresh, frame.receivedAt);
+
+    // Sensors travel with the thermal group; a delta carrying that group
+    // confirms the ones it leaves out
+    if (frame.keyframe) {
+        metrics.unlistSensors();
+    } else if (fresh & GROUP_THERMAL_FIELDS) {
+        metrics.confirmSensors(frame.receivedAt);
+    }
+
+    // Sensors can't overwrite the built-in fields, which follow SystemData
+    for (uint8_t i = 0; i < frame.sensorCount; i++) {
+        const FrameSensor& sensor = frame.sensors[i];
+        int id = metrics.intern(sensor.name, sensor.unit[0] ? sensor.unit : nullptr, sensor.scale);
+        if (id >= metrics.getBuiltinCount()) {
+            metrics.set(id, sensor.value, frame.receivedAt);
+        }
+    }
+}
+
+void CommInterface::recordHistory(const TelemetryFrame& frame, const SystemData& data) {
+    float values[HISTORY_FIELD_COUNT];
+    HistoryStore::valuesFrom(data, values);
+
+    if (frame.batch.count == 0) {
+        queueHistory(frame.receivedAt, frame.hasSendTime, frame.sendTime, values);
+        return;
+    }
+
+    // Place each sample at its original spacing before the frame's arrival;
+    // fields the batch doesn't carry keep the merged value
+    const SampleBatch& batch = frame.batch;
+    for (uint8_t i = 0; i < batch.count; i++) {
+        for (uint8_t field = 0; field < HISTORY_FIELD_COUNT; field++) {
+            if (batch.fields & (1 << field)) {
+                values[field] = batch.get(i, field);
+            }
+        }
+        queueHistory(frame.receivedAt + batch.offsetMs[i], frame.hasSendTime,
+                     frame.sendTime + batch.offsetMs[i], values);
+    }
+}
+
+void CommInterface::queueHistory(unsigned long time, bool hasSenderTime, uint32_t senderTime,
+                                 const float* values) {
+    // Frames coalesced into one pass keep their newest samples
+    if (pendingCount == HISTORY_PENDING_MAX) {
+        memmove(pendingHistory, pendingHistory + 1, sizeof(PendingSample) * (HISTORY_PENDING_MAX - 1));
+        pendingCount--;
+    }
+
+    PendingSample& pending = pendingHistory[pendingCount++];
+    pending.time = time;
+    memcpy(pending.values, values, sizeof(pending.values));
+    pending.hasSenderTime = hasSenderTime;
+    pending.senderTime = senderTime;
+}
+
+void CommInterface::commitHistory() {
+    HistoryStore& history = HistoryStore::getInstance();
+    for (uint8_t i = 0; i < pendingCount; i++) {
+        const PendingSample& pending = pendingHistory[i];
+        history.add(pending.time, pending.hasSenderTime, pending.senderTime, pending.values);
+    }
+    pendingCount = 0;
+}
+
+void CommInterface::noteQueueDepth(uint32_t frames, uint32_t capacity) {
+    if (frames > frameStats.queuePeak) {
+        frameStats.queuePeak = frames;
+    }
+    frameStats.queueCapacity = capacity;
+}
+
+void CommInterface::reportFeedback(const SenderFeedback& feedback) {
+    uint8_t message[FEEDBACK_SIZE];
+    uint8_t flags = feedback.overloaded ? FEEDBACK_FLAG_OVERLOAD : 0;
+
+    // In multi-host mode each host's keyframe state lives in the source table
+    if (frameStats.keyframeNeeded && !Config::getInstance().isMultiHost()) {
+        flags |= FEEDBACK_FLAG_KEYFRAME;
+    }
+
+    message[0] = FEEDBACK_MAGIC;
+    message[1] = flags;
+    writeU16(message + 2, feedback.interval);
+    writeU16(message + 4, feedback.desired);
+    writeU16(message + 6, feedback.renderMs);
+    writeU16(message + 8, feedback.budgetMs);
+    message[10] = frameStats.queuePeak > 0xFF ? 0xFF : frameStats.queuePeak;
+    message[11] = frameStats.queueCapacity > 0xFF ? 0xFF : frameStats.queueCapacity;
+    sendFeedback(message, sizeof(message));
+
+    frameStats.queuePeak = 0;
+}
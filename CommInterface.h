@@ -3,10 +3,131 @@
 
 #include <Arduino.h>
 #include "SystemData.h"
+#include "LinkStats.h"
+#include "Config.h"
+#include "HistoryStore.h"
+#include "CounterRates.h"
+#include "MetricRegistry.h"
+
+#define FRAME_SOURCE_SIZE 24   // Host ID or sender address, with terminator
+#define FRAME_SENSOR_MAX  8    // Extra sensors carried per frame
+#define HISTORY_PENDING_MAX 12 // History samples a link holds between receiveData() passes
+
+// A keyframe with a lower sequence is a sender restart only if it jumps back
+// this far or the link was quiet this long; otherwise it arrived late.
+// applyFrame() alone drops frames on these rules; LinkStats follows them.
+#define FRAME_RESTART_GAP    64
+#define FRAME_RESTART_QUIET  2000   // ms
+
+// Sensor outside the fixed fields, by name; interned when the frame is applied
+struct FrameSensor {
+    char name[METRIC_NAME_SIZE];
+    char unit[METRIC_UNIT_SIZE];   // Empty to keep the registered unit
+    float scale;                   // 0 to keep the registered scale
+    float value;
+};
+
+// Decoded telemetry frame. A keyframe carries every field; a delta frame
+// carries only the fields that changed since the previous frame. A partial
+// delta carries only the field groups due at this point of a multi-rate
+// stream, so the groups it leaves out are not confirmed unchanged.
+struct TelemetryFrame {
+    SystemData data;
+    uint32_t fields;    // FIELD_* bits present in this frame
+    bool keyframe;
+    bool partial;
+    bool hasSeq;
+    uint32_t seq;
+    bool hasSendTime;
+    uint32_t sendTime;  // Sender clock, milliseconds (low 32 bits)
+    unsigned long receivedAt;  // Local millis() when the frame arrived (or left the jitter buffer)
+    uint32_t playoutDelay;     // Time spent in the jitter buffer (ms)
+    uint16_t length;    // Encoded size on the wire
+    uint16_t coalesced; // Earlier frames from the same sender folded into this one
+    SampleBatch batch;  // Extra history samples; count 0 when absent
+    CounterSample counters;  // Raw counters; mask 0 when absent
+    FrameSensor sensors[FRAME_SENSOR_MAX];
+    uint8_t sensorCount;
+    char source[FRAME_SOURCE_SIZE];  // Sending host; empty on single-peer links
+    uint32_t senderAddress;  // Where feedback goes (UDP only, 0 otherwise)
+    uint16_t senderPort;
+
+    TelemetryFrame() : fields(0), keyframe(true), partial(false), hasSeq(false), seq(0),
+                       hasSendTime(false), sendTime(0), receivedAt(0), playoutDelay(0), length(0),
+                       coalesced(0), sensorCount(0), senderAddress(0), senderPort(0) {
+        batch.count = 0;
+        batch.fields = 0;
+        counters.mask = 0;
+        source[0] = '\0';
+    }
+};
+
+// Binary frame layout (little-endian):
+//   [0xB1][flags][seq u32][ts u32][fields u32]
+// then, with FRAME_FLAG_HOST, the host ID as [length u8][bytes], followed by
+// each field set in "fields", in FIELD_* bit order: numbers as
+// float32, names as [length u8][bytes]. With FRAME_FLAG_BATCH a sample batch
+// follows: [count u8][mask u8], then per sample [offset ms i16] and a float32
+// for each HistoryField bit in mask. With FRAME_FLAG_COUNTERS raw counters
+// follow: [mask u8], then a u64 for each CounterId bit in mask.
+// FRAME_FLAG_PARTIAL marks a partial delta ("partial": true in JSON).
+// Payloads starting with '{' are JSON.
+#define FRAME_BINARY_MAGIC   0xB1
+#define FRAME_BINARY_HEADER  14
+#define FRAME_FLAG_KEYFRAME  0x01
+#define FRAME_FLAG_SEQ       0x02
+#define FRAME_FLAG_TS        0x04
+#define FRAME_FLAG_BATCH     0x08
+#define FRAME_FLAG_HOST      0x10
+#define FRAME_FLAG_PARTIAL   0x20
+#define FRAME_FLAG_COUNTERS  0x40
+
+// Feedback sent back to senders about once a second (little-endian):
+//   [0xFB][flags][interval ms u16][desired ms u16][render ms u16][budget ms u16]
+//   [queue u8][capacity u8]
+// "interval" is the sample period the device asks for: the configured one,
+// stretched while it is overloaded. Small enough for one 20-byte BLE notify.
+#define FEEDBACK_MAGIC          0xFB
+#define FEEDBACK_SIZE           12
+#define FEEDBACK_FLAG_KEYFRAME  0x01   // State is stale, send a keyframe
+#define FEEDBACK_FLAG_OVERLOAD  0x02   // Frames were dropped or rendering overran
+
+// Device-wide part of a feedback message; the link adds its own queue state
+struct SenderFeedback {
+    uint32_t interval;    // Requested sample period (ms)
+    uint32_t desired;     // Configured sample period (ms)
+    uint32_t renderMs;    // Longest render since the last report
+    uint32_t budgetMs;    // Time available per render
+    bool overloaded;
+};
+
+// Keyframe/delta bookkeeping for one link
+struct FrameStats {
+    uint32_t keyframes;
+    uint32_t deltas;
+    uint32_t gaps;           // Sequence discontinuities detected
+    uint32_t missedFrames;   // Frames skipped across all gaps
+    uint32_t staleFrames;    // Old or duplicate deltas dropped
+    uint32_t coalesced;      // Frames merged but superseded before delivery
+    uint32_t overflows;      // Frames dropped because the receive queue was full
+    uint32_t frames;         // Frames decoded, including duplicates
+    uint32_t bytes;          // Encoded bytes of those frames
+    uint32_t queuePeak;      // Most frames waiting for loop() since the last feedback
+    uint32_t queueCapacity;
+    bool keyframeNeeded;     // State may be stale until the next keyframe
+
+    FrameStats() : keyframes(0), deltas(0), gaps(0), missedFrames(0),
+                   staleFrames(0), coalesced(0), overflows(0), frames(0), bytes(0),
+                   queuePeak(0), queueCapacity(0), keyframeNeeded(true) {}
+};
+
+// Called from loop() when a link comes up (true) or goes down (false)
+typedef void (*LinkCallback)(CommInterfaceType link, bool up);
 
 // Abstract communication interface
 class CommInterface {
 public:
+    CommInterface(CommInterfaceType type);
     virtual ~CommInterface() {}
 
     virtual bool begin() = 0;
@@ -15,8 +136,57 @@ public:
     virtual bool receiveData(SystemData& data) = 0;
     virtual void stop() = 0;
 
+    CommInterfaceType getType() const { return type; }
+    const FrameStats& getFrameStats() const { return frameStats; }
+    const LinkStats& getLinkStats() const { return linkStats; }
+    void requestKeyframe() { frameStats.keyframeNeeded = true; }
+    void setLinkCallback(LinkCallback callback) { linkCallback = callback; }
+
+    // Tell the sender(s) on this link how fast to send; resets the queue peak
+    void reportFeedback(const SenderFeedback& feedback);
+
+    // Sequence number of the newest applied frame
+    bool hasLastSeq() const { return haveSeq; }
+    uint32_t getLastSeq() const { return lastSeq; }
+
+    // History from the frames applied since the last pass, kept until
+    // CommManager knows whether this link's update was accepted
+    void commitHistory();
+    void discardHistory() { pendingCount = 0; }
+
 protected:
     bool parseJSON(const char* json, SystemData& data);
+    bool applyFrame(const TelemetryFrame& frame, SystemData& data);
+    void recordHistory(const TelemetryFrame& frame, const SystemData& data);
+    void updateMetrics(const TelemetryFrame& frame, const SystemData& data, uint32_t fresh);
+    void countCoalesced(uint32_t frames) { frameStats.coalesced += frames; }
+    void setOverflows(uint32_t frames) { frameStats.overflows = frames; }
+    void noteQueueDepth(uint32_t frames, uint32_t capacity);
+    // Deliver an encoded feedback message; links that can't reply ignore it
+    virtual void sendFeedback(const uint8_t* message, size_t length) {}
+    void notifyLink(bool up) { if (linkCallback) linkCallback(type, up); }
+
+    // Stateless, so they may run on a network task while the loop applies frames
+    static bool decodePayload(const uint8_t* payload, size_t length, TelemetryFrame& frame);
+    static bool decodeJSON(const char* json, size_t length, TelemetryFrame& frame);
+    static bool decodeBinary(const uint8_t* payload, size_t length, TelemetryFrame& frame);
+    static bool decodeBatch(const uint8_t*& p, const uint8_t* end, SampleBatch& batch);
+    static bool decodeCounters(const uint8_t*& p, const uint8_t* end, CounterSample& counters);
+    // Key frames without a host ID by their sender (network links only)
+    static void setSourceAddress(TelemetryFrame& frame, const IPAddress& address);
+
+private:
+    CommInterfaceType type;
+    FrameStats frameStats;
+    LinkStats linkStats;
+    uint32_t lastSeq;
+    bool haveSeq;
+    unsigned long lastApplied;   // receivedAt of the newest applied frame
+    LinkCallback linkCallback;
+    PendingSample pendingHistory[HISTORY_PENDING_MAX];
+    uint8_t pendingCount;
+
+    void queueHistory(unsigned long time, bool hasSenderTime, uint32_t senderTime, const float* values);
 };
 
 #endif
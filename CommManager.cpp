@@ -1,6 +1,15 @@
 #include "CommManager.h"
 
-CommManager::CommManager() : activeInterface(nullptr) {
+CommManager::CommManager() : preferredLink(COMM_WIFI), activeLink(COMM_WIFI),
+                             haveDeliveredSeq(false), deliveredSeq(0),
+                             firstDataTime(0), rateWindowStart(0), lastFeedback(0) {
+    interfaces[COMM_WIFI] = &wifiComm;
+    interfaces[COMM_BLE] = &bleComm;
+    interfaces[COMM_TCP] = &tcpComm;
+    interfaces[COMM_SERIAL] = &serialComm;
+    memset(health, 0, sizeof(health));
+    memset(&feedback, 0, sizeof(feedback));
+    memset(feedbackOverflows, 0, sizeof(feedbackOverflows));
 }
 
 CommManager::~CommManager() {
@@ -12,41 +21,296 @@ CommManager& CommManager::getInstance() {
     return instance;
 }
 
+const char* CommManager::getLinkName(CommInterfaceType type) {
+    static const char* names[] = {"WiFi", "BLE", "TCP", "Serial"};
+    return type < COMM_MAX_INTERFACES ? names[type] : "?";
+}
+
 bool CommManager::begin() {
     Config& cfg = Config::getInstance();
-    CommInterfaceType interface = cfg.getCommInterface();
+    uint8_t links = cfg.getCommLinks();
 
-    if (interface == COMM_WIFI) {
-        Serial.println("Starting WiFi communication...");
-        activeInterface = &wifiComm;
-    } else {
-        Serial.println("Starting BLE communication...");
-        activeInterface = &bleComm;
+    preferredLink = cfg.getCommInterface();
+    activeLink = preferredLink;
+
+    // Every enabled link runs; the preferred one is used while it carries data
+    bool started = false;
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        health[i].enabled = (links & COMM_LINK_BIT(i)) != 0;
+        if (health[i].enabled && startLink((CommInterfaceType)i)) {
+            started = true;
+        }
     }
+    rateWindowStart = millis();
+    return started;
+}
 
-    return activeInterface->begin();
+bool CommManager::startLink(CommInterfaceType type) {
+    Serial.printf("Starting %s communication%s...\r\n", getLinkName(type),
+                  type == preferredLink ? "" : " (standby)");
+    health[type].started = interfaces[type]->begin();
+    return health[type].started;
+}
+
+void CommManager::reconfigure() {
+    Config& cfg = Config::getInstance();
+    uint8_t links = cfg.getCommLinks();
+
+    preferredLink = cfg.getCommInterface();
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        health[i].enabled = (links & COMM_LINK_BIT(i)) != 0;
+        if (health[i].enabled && !health[i].started) {
+            startLink((CommInterfaceType)i);
+        }
+    }
+    selectActiveLink(millis());
+}
+
+void CommManager::setLinkCallback(LinkCallback callback) {
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        interfaces[i]->setLinkCallback(callback);
+    }
 }
 
 void CommManager::update() {
-    if (activeInterface) {
-        activeInterface->update();
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        if (health[i].started) {
+            interfaces[i]->update();
+        }
     }
+
+    unsigned long now = millis();
+    selectActiveLink(now);
+    updateRates(now);
+    updateFeedback(now);
 }
 
 bool CommManager::isConnected() {
-    return activeInterface && activeInterface->isConnected();
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        if (health[i].started && interfaces[i]->isConnected()) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool CommManager::receiveData(SystemData& data) {
-    if (activeInterface) {
-        return activeInterface->receiveData(data);
+    unsigned long now = millis();
+    bool delivered = false;
+
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        CommLinkHealth& h = health[i];
+        if (!h.started || !interfaces[i]->receiveData(linkData[i])) {
+            continue;
+        }
+
+        if (h.lastReceive > 0) {
+            unsigned long interval = now - h.lastReceive;
+            h.period = h.period == 0 ? interval : (h.period * 7 + interval) / 8;
+        }
+        h.lastReceive = now;
+        h.updates++;
+
+        if (acceptUpdate((CommInterfaceType)i)) {
+            // Dirty groups move to data; a link that wasn't delivered keeps
+            // its own, so switching to it redraws what it changed meanwhile
+            uint8_t dirty = data.dirtyGroups;
+            data = linkData[i];
+            data.dirtyGroups |= dirty;
+            linkData[i].clearDirty();
+            interfaces[i]->commitHistory();
+            h.delivered++;
+            delivered = true;
+        } else {
+            // A rejected standby stream must not reach the graphs
+            interfaces[i]->discardHistory();
+            h.duplicates++;
+        }
+    }
+
+    // Check for a quiet link here too, so failover happens on this pass
+    selectActiveLink(now);
+
+    if (delivered && firstDataTime == 0) {
+        firstDataTime = now;
+        Serial.printf("First data %lu ms after boot\r\n", firstDataTime);
+    }
+    return delivered;
+}
+
+bool CommManager::acceptUpdate(CommInterfaceType type) {
+    CommInterface* link = interfaces[type];
+    CommLinkHealth& h = health[type];
+
+    // Unsequenced streams can't be merged, so only the active link is used
+    if (!link->hasLastSeq()) {
+        return type == activeLink;
+    }
+
+    // The link itself accepted an older sequence: the sender restarted
+    uint32_t seq = link->getLastSeq();
+    bool restarted = h.haveSeq && (int32_t)(seq - h.seq) < 0;
+    h.seq = seq;
+    h.haveSeq = true;
+
+    // The same stream on several links: the first copy of each frame wins
+    if (!haveDeliveredSeq || (int32_t)(seq - deliveredSeq) > 0 ||
+        (restarted && type == activeLink)) {
+        deliveredSeq = seq;
+        haveDeliveredSeq = true;
+        return true;
     }
     return false;
 }
 
+bool CommManager::isLinkQuiet(CommInterfaceType type) {
+    const CommLinkHealth& h = health[type];
+    if (!h.started || h.lastReceive == 0) {
+        return true;
+    }
+
+    // Quiet once an expected sample is half a period late
+    unsigned long timeout = h.period > 0 ? h.period + h.period / 2 : COMM_QUIET_DEFAULT;
+    if (timeout < COMM_QUIET_MIN) {
+        timeout = COMM_QUIET_MIN;
+    }
+    return millis() - h.lastReceive > timeout;
+}
+
+void CommManager::selectActiveLink(unsigned long now) {
+    CommInterfaceType next = activeLink;
+
+    if (!isLinkQuiet(preferredLink)) {
+        // Fall back to the preferred link as soon as it carries data again
+        next = preferredLink;
+    } else if (isLinkQuiet(activeLink)) {
+        for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+            if (!isLinkQuiet((CommInterfaceType)i)) {
+                next = (CommInterfaceType)i;
+                break;
+            }
+        }
+    }
+
+    if (next != activeLink) {
+        Serial.printf("Link failover: %s -> %s (%lu ms since last %s data)\r\n",
+                      getLinkName(activeLink), getLinkName(next),
+                      health[activeLink].lastReceive > 0 ? now - health[activeLink].lastReceive : 0UL,
+                      getLinkName(activeLink));
+        health[next].failovers++;
+        activeLink = next;
+    }
+}
+
+void CommManager::updateRates(unsigned long now) {
+    unsigned long elapsed = now - rateWindowStart;
+    if (elapsed < COMM_RATE_WINDOW) {
+        return;
+    }
+
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        CommLinkHealth& h = health[i];
+        const FrameStats& frames = interfaces[i]->getFrameStats();
+        h.frameRate = (frames.frames - h.windowFrames) * 1000.0f / elapsed;
+        h.byteRate = (frames.bytes - h.windowBytes) * 1000.0f / elapsed;
+        h.windowFrames = frames.frames;
+        h.windowBytes = frames.bytes;
+    }
+    rateWindowStart = now;
+}
+
+void CommManager::setRenderTime(uint32_t ms, uint32_t budgetMs) {
+    if (ms > feedback.renderMs) {
+        feedback.renderMs = ms;
+    }
+    feedback.budgetMs = budgetMs;
+}
+
+void CommManager::updateFeedback(unsigned long now) {
+    if (now - lastFeedback < COMM_FEEDBACK_PERIOD) {
+        return;
+    }
+    lastFeedback = now;
+
+    // Overloaded when a queue dropped frames or ran more than half full, or a
+    // render took longer than the display update period
+    bool overloaded = feedback.budgetMs > 0 && feedback.renderMs > feedback.budgetMs;
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        if (!health[i].started) {
+            continue;
+        }
+        const FrameStats& frames = interfaces[i]->getFrameStats();
+        if (frames.overflows != feedbackOverflows[i] || frames.queuePeak * 2 > frames.queueCapacity) {
+            overloaded = true;
+        }
+        feedbackOverflows[i] = frames.overflows;
+    }
+
+    // Back off fast and recover slowly: double the period on overload, then
+    // shorten it by an eighth per healthy report down to the configured one
+    uint32_t desired = Config::getInstance().getSampleInterval();
+    uint32_t interval = feedback.requestedInterval;
+    if (overloaded) {
+        interval = interval * 2 > SAMPLE_INTERVAL_MAX ? SAMPLE_INTERVAL_MAX : interval * 2;
+        feedback.overloads++;
+    } else {
+        interval -= interval / 8;
+    }
+    feedback.requestedInterval = interval < desired ? desired : interval;
+    feedback.overloaded = overloaded;
+
+    SenderFeedback message;
+    message.interval = feedback.requestedInterval;
+    message.desired = desired;
+    message.renderMs = feedback.renderMs;
+    message.budgetMs = feedback.budgetMs;
+    message.overloaded = overloaded;
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        if (health[i].started) {
+            interfaces[i]->reportFeedback(message);
+        }
+    }
+    feedback.reports++;
+    feedback.renderMs = 0;
+}
+
 void CommManager::stop() {
-    if (activeInterface) {
-        activeInterface->stop();
-        activeInterface = nullptr;
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        if (health[i].started) {
+            interfaces[i]->stop();
+            health[i].started = false;
+        }
     }
 }
+
+const FrameStats* CommManager::getFrameStats() {
+    return health[activeLink].started ? &interfaces[activeLink]->getFrameStats() : nullptr;
+}
+
+const LinkStats* CommManager::getLinkStats() {
+    return health[activeLink].started ? &interfaces[activeLink]->getLinkStats() : nullptr;
+}
+
+const BLELinkStats* CommManager::getBLEStats() {
+    return health[COMM_BLE].started ? &bleComm.getStats() : nullptr;
+}
+
+const FrameDecompressor* CommManager::getBLEDecompressor() {
+    return health[COMM_BLE].started ? &bleComm.getDecompressor() : nullptr;
+}
+
+const WiFiLinkStats* CommManager::getWiFiStats() {
+    return health[COMM_WIFI].started ? &wifiComm.getStats() : nullptr;
+}
+
+const PlayoutBuffer* CommManager::getWiFiPlayout() {
+    return health[COMM_WIFI].started ? &wifiComm.getPlayout() : nullptr;
+}
+
+const TcpLinkStats* CommManager::getTcpStats() {
+    return health[COMM_TCP].started ? &tcpComm.getStats() : nullptr;
+}
+
+const SerialLinkStats* CommManager::getSerialStats() {
+    return health[COMM_SERIAL].started ? &serialComm.getStats() : nullptr;
+}
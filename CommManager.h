@@ -4,8 +4,48 @@
 #include "CommInterface.h"
 #include "WiFiComm.h"
 #include "BLEComm.h"
+#include "TcpComm.h"
+#include "SerialComm.h"
 #include "Config.h"
 
+#define COMM_MAX_INTERFACES 4
+#define COMM_QUIET_DEFAULT  2000   // Quiet timeout before the sample period is known (ms)
+#define COMM_QUIET_MIN      100    // Lower bound for the quiet timeout (ms)
+#define COMM_RATE_WINDOW    1000   // Throughput measurement window (ms)
+#define COMM_FEEDBACK_PERIOD 1000  // Sender feedback interval (ms)
+
+// Device load as reported to senders
+struct CommFeedbackStats {
+    uint32_t requestedInterval;   // Sample period currently asked for (ms)
+    uint32_t renderMs;            // Longest render in the last period
+    uint32_t budgetMs;
+    bool overloaded;
+    uint32_t overloads;           // Periods that stretched the interval
+    uint32_t reports;
+};
+
+// Health and throughput of one interface
+struct CommLinkHealth {
+    bool enabled;
+    bool started;
+    uint32_t updates;          // receiveData() calls that produced new state
+    uint32_t delivered;        // Updates that were the newest across links
+    uint32_t duplicates;       // Updates already delivered by another link
+    uint32_t failovers;        // Times this link took over as the active link
+    unsigned long lastReceive;
+    unsigned long period;      // Smoothed interval between updates (ms)
+    float frameRate;           // Frames/s over the last window
+    float byteRate;            // Bytes/s over the last window
+
+    // Sequence tracking for merge and sender-restart detection
+    bool haveSeq;
+    uint32_t seq;
+
+    // Throughput window
+    uint32_t windowFrames;
+    uint32_t windowBytes;
+};
+
 class CommManager {
 public:
     static CommManager& getInstance();
@@ -16,13 +56,78 @@ public:
     bool receiveData(SystemData& data);
     void stop();
 
+    // Apply interface settings changed at runtime: new preferred link and any
+    // newly enabled links take effect now, disabled links after a restart
+    void reconfigure();
+
+    // Notified from loop() when a link comes up or goes down
+    void setLinkCallback(LinkCallback callback);
+
+    // Keyframe/delta statistics of the active link (nullptr if none)
+    const FrameStats* getFrameStats();
+
+    // End-to-end link statistics of the active link (nullptr if none)
+    const LinkStats* getLinkStats();
+
+    // BLE link counters (nullptr unless BLE is running)
+    const BLELinkStats* getBLEStats();
+
+    // BLE payload decompression (nullptr unless BLE is running)
+    const FrameDecompressor* getBLEDecompressor();
+
+    // WiFi supervisor state (nullptr unless WiFi is running)
+    const WiFiLinkStats* getWiFiStats();
+
+    // WiFi jitter buffer (nullptr unless WiFi is running)
+    const PlayoutBuffer* getWiFiPlayout();
+
+    // TCP stream counters (nullptr unless TCP is running)
+    const TcpLinkStats* getTcpStats();
+
+    // Serial frame counters (nullptr unless serial telemetry is running)
+    const SerialLinkStats* getSerialStats();
+
+    // Per-interface health, indexed by CommInterfaceType
+    const CommLinkHealth& getHealth(CommInterfaceType type) const { return health[type]; }
+    CommInterfaceType getActiveLink() const { return activeLink; }
+    bool isLinkQuiet(CommInterfaceType type);
+    static const char* getLinkName(CommInterfaceType type);
+
+    // Time one display render took, and how long it may take, for feedback
+    void setRenderTime(uint32_t ms, uint32_t budgetMs);
+    const CommFeedbackStats& getFeedbackStats() const { return feedback; }
+
+    // millis() at the first received packet (0 if none yet)
+    unsigned long getFirstDataTime() const { return firstDataTime; }
+
 private:
     CommManager();
     ~CommManager();
 
-    CommInterface* activeInterface;
     WiFiComm wifiComm;
     BLEComm bleComm;
+    TcpComm tcpComm;
+    SerialComm serialComm;
+    CommInterface* interfaces[COMM_MAX_INTERFACES];
+    CommLinkHealth health[COMM_MAX_INTERFACES];
+    SystemData linkData[COMM_MAX_INTERFACES];   // Latest state per link
+
+    CommInterfaceType preferredLink;
+    CommInterfaceType activeLink;
+    bool haveDeliveredSeq;
+    uint32_t deliveredSeq;
+    unsigned long firstDataTime;
+    unsigned long rateWindowStart;
+
+    CommFeedbackStats feedback;
+    unsigned long lastFeedback;
+    uint32_t feedbackOverflows[COMM_MAX_INTERFACES];   // Ring overflows at the last report
+
+    bool startLink(CommInterfaceType type);
+    bool acceptUpdate(CommInterfaceType type);
+    void selectActiveLink(unsigned long now);
+    void updateRates(unsigned long now);
+    void updateFeedback(unsigned long now);
 };
 
 #endif
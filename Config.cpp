@@ -5,9 +5,18 @@
 Config::Config() {
     // Default values
     commInterface = COMM_WIFI;
+    commLinks = 0;
+    serialBaud = 115200;
     wifiSSID = "";
     wifiPassword = "";
+    memset(&wifiCache, 0, sizeof(wifiCache));
+    memset(&staticIP, 0, sizeof(staticIP));
+    wifiFastLease = false;
+    jitterBuffer = false;
+    multiHost = false;
+    multicastGroup = 0;
     bleName = "ESP32_Monitor";
+    bleProfile = BLE_PROFILE_AUTO;
     mdnsName = "esp32monitor";
     displayTheme = THEME_DEFAULT;
     brightness = 128;
@@ -18,6 +27,7 @@ Config::Config() {
     alertThresholds.diskLow = 10.0;
 
     idleTimeout = 30;  // Default 30 seconds
+    sampleInterval = 1000;
 
     // Default date/time (2025-01-01 00:00:00)
     dateYear = 2025;
@@ -46,9 +56,26 @@ void Config::begin() {
 
 void Config::loadSettings() {
     commInterface = (CommInterfaceType)prefs.getUChar("commIf", COMM_WIFI);
+    commLinks = prefs.getUChar("commLinks", 0);
+    serialBaud = prefs.getUInt("serialBaud", 115200);
     wifiSSID = prefs.getString("wifiSSID", "");
     wifiPassword = prefs.getString("wifiPass", "");
+    if (prefs.getBytes("wifiCache", &wifiCache, sizeof(wifiCache)) != sizeof(wifiCache)) {
+        memset(&wifiCache, 0, sizeof(wifiCache));
+    }
+    staticIP.ip = prefs.getUInt("ipAddr", 0);
+    staticIP.gateway = prefs.getUInt("ipGateway", 0);
+    staticIP.subnet = prefs.getUInt("ipSubnet", 0);
+    staticIP.dns = prefs.getUInt("ipDNS", 0);
+    wifiFastLease = prefs.getBool("wifiFast", false);
+    multicastGroup = prefs.getUInt("mcastGroup", 0);
+    jitterBuffer = prefs.getBool("jitterBuf", false);
+    multiHost = prefs.getBool("multiHost", false);
     bleName = prefs.getString("bleName", "ESP32_Monitor");
+    bleProfile = (BLEProfile)prefs.getUChar("bleProfile", BLE_PROFILE_AUTO);
+    if (bleProfile > BLE_PROFILE_LOW_POWER) {
+        bleProfile = BLE_PROFILE_AUTO;  // Indexes name tables, so never out of range
+    }
     mdnsName = prefs.getString("mdnsName", "esp32monitor");
     displayTheme = (DisplayTheme)prefs.getUChar("theme", THEME_DEFAULT);
     brightness = prefs.getUChar("brightness", 128);
@@ -59,6 +86,7 @@ void Config::loadSettings() {
     alertThresholds.diskLow = prefs.getFloat("alertDisk", 10.0);
 
     idleTimeout = prefs.getUShort("idleTimeout", 30);
+    sampleInterval = prefs.getUShort("sampleMs", 1000);
 
     // Load date/time settings
     dateYear = prefs.getInt("dtYear", 2025);
@@ -77,9 +105,21 @@ void Config::loadSettings() {
 
 void Config::saveSettings() {
     prefs.putUChar("commIf", (uint8_t)commInterface);
+    prefs.putUChar("commLinks", commLinks);
+    prefs.putUInt("serialBaud", serialBaud);
     prefs.putString("wifiSSID", wifiSSID);
     prefs.putString("wifiPass", wifiPassword);
+    prefs.putBytes("wifiCache", &wifiCache, sizeof(wifiCache));
+    prefs.putUInt("ipAddr", staticIP.ip);
+    prefs.putUInt("ipGateway", staticIP.gateway);
+    prefs.putUInt("ipSubnet", staticIP.subnet);
+    prefs.putUInt("ipDNS", staticIP.dns);
+    prefs.putBool("wifiFast", wifiFastLease);
+    prefs.putUInt("mcastGroup", multicastGroup);
+    prefs.putBool("jitterBuf", jitterBuffer);
+    prefs.putBool("multiHost", multiHost);
     prefs.putString("bleName", bleName);
+    prefs.putUChar("bleProfile", (uint8_t)bleProfile);
     prefs.putString("mdnsName", mdnsName);
     prefs.putUChar("theme", (uint8_t)displayTheme);
     prefs.putUChar("brightness", brightness);
@@ -90,6 +130,7 @@ void Config::saveSettings() {
     prefs.putFloat("alertDisk", alertThresholds.diskLow);
 
     prefs.putUShort("idleTimeout", idleTimeout);
+    prefs.putUShort("sampleMs", sampleInterval);
 
     // Save date/time settings
     prefs.putInt("dtYear", dateYear);
@@ -120,7 +161,23 @@ CommInterfaceType Config::getCommInterface() {
     return commInterface;
 }
 
+void Config::setCommLinks(uint8_t links) {
+    commLinks = links;
+    prefs.putUChar("commLinks", links);
+}
+
+uint8_t Config::getCommLinks() {
+    uint8_t links = commLinks | COMM_LINK_BIT(commInterface);
+    if (links & COMM_LINK_BIT(COMM_TCP)) {
+        links |= COMM_LINK_BIT(COMM_WIFI);  // TCP needs the WiFi link up
+    }
+    return links;
+}
+
 void Config::setWiFiSSID(const char* ssid) {
+    if (wifiSSID != ssid) {
+        clearWiFiCache();  // Cached AP belongs to the old network
+    }
     wifiSSID = ssid;
     prefs.putString("wifiSSID", wifiSSID);
 }
@@ -130,29 +187,104 @@ void Config::setWiFiPassword(const char* password) {
     prefs.putString("wifiPass", wifiPassword);
 }
 
-String Config::getWiFiSSID() {
+const String& Config::getWiFiSSID() {
     return wifiSSID;
 }
 
-String Config::getWiFiPassword() {
+const String& Config::getWiFiPassword() {
     return wifiPassword;
 }
 
+void Config::setWiFiCache(const WiFiCache& cache) {
+    // Called on every connect; only touch flash when something changed
+    if (memcmp(&cache, &wifiCache, sizeof(wifiCache)) == 0) {
+        return;
+    }
+    wifiCache = cache;
+    prefs.putBytes("wifiCache", &wifiCache, sizeof(wifiCache));
+}
+
+WiFiCache Config::getWiFiCache() {
+    return wifiCache;
+}
+
+void Config::clearWiFiCache() {
+    memset(&wifiCache, 0, sizeof(wifiCache));
+    prefs.remove("wifiCache");
+}
+
+void Config::setStaticIP(const StaticIPConfig& ipConfig) {
+    staticIP = ipConfig;
+    prefs.putUInt("ipAddr", staticIP.ip);
+    prefs.putUInt("ipGateway", staticIP.gateway);
+    prefs.putUInt("ipSubnet", staticIP.subnet);
+    prefs.putUInt("ipDNS", staticIP.dns);
+}
+
+StaticIPConfig Config::getStaticIP() {
+    return staticIP;
+}
+
+void Config::setWiFiFastLease(bool enabled) {
+    wifiFastLease = enabled;
+    prefs.putBool("wifiFast", enabled);
+}
+
+bool Config::getWiFiFastLease() {
+    return wifiFastLease;
+}
+
+void Config::setMulticastGroup(uint32_t group) {
+    multicastGroup = group;
+    prefs.putUInt("mcastGroup", group);
+}
+
+uint32_t Config::getMulticastGroup() {
+    return multicastGroup;
+}
+
+void Config::setJitterBuffer(bool enabled) {
+    jitterBuffer = enabled;
+    prefs.putBool("jitterBuf", enabled);
+}
+
+bool Config::getJitterBuffer() {
+    return jitterBuffer;
+}
+
+void Config::setMultiHost(bool enabled) {
+    multiHost = enabled;
+    prefs.putBool("multiHost", enabled);
+}
+
+bool Config::isMultiHost() {
+    return multiHost;
+}
+
 void Config::setBLEName(const char* name) {
     bleName = name;
     prefs.putString("bleName", bleName);
 }
 
-String Config::getBLEName() {
+const String& Config::getBLEName() {
     return bleName;
 }
 
+void Config::setBLEProfile(BLEProfile profile) {
+    bleProfile = profile;
+    prefs.putUChar("bleProfile", (uint8_t)profile);
+}
+
+BLEProfile Config::getBLEProfile() {
+    return bleProfile;
+}
+
 void Config::setMDNSName(const char* name) {
     mdnsName = name;
     prefs.putString("mdnsName", mdnsName);
 }
 
-String Config::getMDNSName() {
+const String& Config::getMDNSName() {
     return mdnsName;
 }
 
@@ -185,6 +317,15 @@ AlertThresholds Config::getAlertThresholds() {
     return alertThresholds;
 }
 
+void Config::setSerialBaud(uint32_t baud) {
+    serialBaud = baud;
+    prefs.putUInt("serialBaud", baud);
+}
+
+uint32_t Config::getSerialBaud() {
+    return serialBaud;
+}
+
 void Config::setServerPort(uint16_t port) {
     serverPort = port;
     prefs.putUShort("port", port);
@@ -215,25 +356,19 @@ void Config::getDateTime(int& year, int& month, int& day, int& hour, int& minute
     second = timeSecond;
 }
 
-String Config::getFormattedDate() {
+void Config::getFormattedDate(char* buf, size_t size) {
     updateTime();
-    char buf[16];
-    sprintf(buf, "%04d-%02d-%02d", dateYear, dateMonth, dateDay);
-    return String(buf);
+    snprintf(buf, size, "%04d-%02d-%02d", dateYear, dateMonth, dateDay);
 }
 
-String Config::getFormattedTime() {
+void Config::getFormattedTime(char* buf, size_t size) {
     updateTime();
-    char buf[16];
-    sprintf(buf, "%02d:%02d", timeHour, timeMinute);
-    return String(buf);
+    snprintf(buf, size, "%02d:%02d", timeHour, timeMinute);
 }
 
-String Config::getFormattedDateTime() {
+void Config::getFormattedDateTime(char* buf, size_t size) {
     updateTime();
-    char buf[32];
-    sprintf(buf, "%04d-%02d-%02d %02d:%02d", dateYear, dateMonth, dateDay, timeHour, timeMinute);
-    return String(buf);
+    snprintf(buf, size, "%04d-%02d-%02d %02d:%02d", dateYear, dateMonth, dateDay, timeHour, timeMinute);
 }
 
 void Config::updateTime() {
@@ -329,7 +464,7 @@ void Config::setNTPServer(const char* server) {
     prefs.putString("ntpServer", ntpServer);
 }
 
-String Config::getNTPServer() {
+const String& Config::getNTPServer() {
     return ntpServer;
 }
 
@@ -359,3 +494,12 @@ void Config::setIdleTimeout(uint16_t seconds) {
 uint16_t Config::getIdleTimeout() {
     return idleTimeout;
 }
+
+void Config::setSampleInterval(uint16_t ms) {
+    sampleInterval = ms;
+    prefs.putUShort("sampleMs", sampleInterval);
+}
+
+uint16_t Config::getSampleInterval() {
+    return sampleInterval;
+}
@@ -7,7 +7,23 @@
 // Communication interface types
 enum CommInterfaceType {
     COMM_WIFI = 0,
-    COMM_BLE = 1
+    COMM_BLE = 1,
+    COMM_TCP = 2,    // Stream over the WiFi link
+    COMM_SERIAL = 3  // Binary frames on the CLI serial port
+};
+
+// Bit for an interface in the enabled-links mask
+#define COMM_LINK_BIT(type) (1 << (type))
+
+// Sample period senders may be asked for (ms); overload stretches it up to the max
+#define SAMPLE_INTERVAL_MIN 100
+#define SAMPLE_INTERVAL_MAX 10000
+
+// BLE connection parameter profiles
+enum BLEProfile {
+    BLE_PROFILE_AUTO = 0,         // Low latency while data flows, low power when idle
+    BLE_PROFILE_LOW_LATENCY = 1,
+    BLE_PROFILE_LOW_POWER = 2
 };
 
 // Display themes
@@ -15,9 +31,14 @@ enum DisplayTheme {
     THEME_DEFAULT = 0,
     THEME_MINIMAL = 1,
     THEME_GRAPH = 2,
-    THEME_COMPACT = 3
+    THEME_COMPACT = 3,
+    THEME_GRID = 4,      // One tile per host (with multi-host mode on)
+    THEME_SENSORS = 5    // Every registered metric, extra sensors included
 };
 
+// "YYYY-MM-DD HH:MM" and terminator, the longest formatted date/time
+#define FORMATTED_TIME_SIZE 20
+
 // Alert thresholds
 struct AlertThresholds {
     float cpuTempHigh;
@@ -25,6 +46,25 @@ struct AlertThresholds {
     float diskLow;
 };
 
+// Last successful association, used for a directed reconnect
+struct WiFiCache {
+    bool valid;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;        // DHCP lease (network byte order, as IPAddress)
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+// Static IP settings; ip == 0 means DHCP
+struct StaticIPConfig {
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
 class Config {
 public:
     static Config& getInstance();
@@ -34,21 +74,42 @@ public:
 
     // Communication settings
     void setCommInterface(CommInterfaceType interface);
-    CommInterfaceType getCommInterface();
+    CommInterfaceType getCommInterface();          // Preferred link
+    void setCommLinks(uint8_t links);              // COMM_LINK_BIT mask of standby links
+    uint8_t getCommLinks();                        // Always includes the preferred link (and WiFi under TCP)
 
     // WiFi settings
     void setWiFiSSID(const char* ssid);
     void setWiFiPassword(const char* password);
-    String getWiFiSSID();
-    String getWiFiPassword();
+    const String& getWiFiSSID();
+    const String& getWiFiPassword();
+
+    // Fast association: cached BSSID/channel/lease and optional static IP
+    void setWiFiCache(const WiFiCache& cache);
+    WiFiCache getWiFiCache();
+    void clearWiFiCache();
+    void setStaticIP(const StaticIPConfig& ipConfig);
+    StaticIPConfig getStaticIP();
+    void setWiFiFastLease(bool enabled);   // Reuse the cached lease on directed connects
+    bool getWiFiFastLease();
+
+    // Multicast group to receive telemetry on (0 = unicast only)
+    void setMulticastGroup(uint32_t group);
+    uint32_t getMulticastGroup();
+    void setJitterBuffer(bool enabled);    // Smooth out bursty UDP delivery
+    bool getJitterBuffer();
+    void setMultiHost(bool enabled);       // Track every sending host (grid theme)
+    bool isMultiHost();
 
     // BLE settings
     void setBLEName(const char* name);
-    String getBLEName();
+    const String& getBLEName();
+    void setBLEProfile(BLEProfile profile);
+    BLEProfile getBLEProfile();
 
     // mDNS settings
     void setMDNSName(const char* name);
-    String getMDNSName();
+    const String& getMDNSName();
 
     // Display settings
     void setDisplayTheme(DisplayTheme theme);
@@ -60,6 +121,10 @@ public:
     void setAlertThresholds(AlertThresholds thresholds);
     AlertThresholds getAlertThresholds();
 
+    // Serial port (CLI and serial telemetry)
+    void setSerialBaud(uint32_t baud);
+    uint32_t getSerialBaud();
+
     // Server settings
     void setServerPort(uint16_t port);
     uint16_t getServerPort();
@@ -68,18 +133,23 @@ public:
     void setIdleTimeout(uint16_t seconds);
     uint16_t getIdleTimeout();
 
+    // Sample period requested from senders via feedback (ms)
+    void setSampleInterval(uint16_t ms);
+    uint16_t getSampleInterval();
+
     // Date/Time settings
     void setDateTime(int year, int month, int day, int hour, int minute, int second);
     void getDateTime(int& year, int& month, int& day, int& hour, int& minute, int& second);
-    String getFormattedDate();
-    String getFormattedTime();
-    String getFormattedDateTime();
+    // Write into the caller's buffer (FORMATTED_TIME_SIZE fits any of them)
+    void getFormattedDate(char* buf, size_t size);
+    void getFormattedTime(char* buf, size_t size);
+    void getFormattedDateTime(char* buf, size_t size);
     void updateTime();  // Updates internal time counter
 
     // NTP settings
     bool syncTimeWithNTP(const char* ntpServer = "pool.ntp.org", long gmtOffset = 0, int daylightOffset = 0);
     void setNTPServer(const char* server);
-    String getNTPServer();
+    const String& getNTPServer();
     void setGMTOffset(long offset);
     long getGMTOffset();
     void setDaylightOffset(int offset);
@@ -90,15 +160,25 @@ private:
     Preferences prefs;
 
     CommInterfaceType commInterface;
+    uint8_t commLinks;
+    uint32_t serialBaud;
     String wifiSSID;
     String wifiPassword;
+    WiFiCache wifiCache;
+    StaticIPConfig staticIP;
+    bool wifiFastLease;
+    uint32_t multicastGroup;
+    bool jitterBuffer;
+    bool multiHost;
     String bleName;
+    BLEProfile bleProfile;
     String mdnsName;
     DisplayTheme displayTheme;
     uint8_t brightness;
     AlertThresholds alertThresholds;
     uint16_t serverPort;
     uint16_t idleTimeout;  // Seconds before returning to idle screen
+    uint16_t sampleInterval;
 
     // Date/Time storage
     int dateYear;
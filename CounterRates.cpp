@@ -0,0 +1,159 @@
+#include "CounterRates.h"
+
+// JSON keys in CounterId order
+static const char* const counterNames[COUNTER_COUNT] = {
+    "net_tx", "net_rx", "disk_read", "disk_write", "disk_reads", "disk_writes"
+};
+
+CounterRates& CounterRates::getInstance() {
+    static CounterRates instance;
+    return instance;
+}
+
+CounterRates::CounterRates() {
+    clear();
+}
+
+void CounterRates::clear() {
+    memset(tracks, 0, sizeof(tracks));
+    memset(&stats, 0, sizeof(stats));
+    haveTime = false;
+    lastTime = 0;
+}
+
+void CounterRates::restartHistory() {
+    // Totals carry on; only the time base changed
+    for (uint8_t id = 0; id < COUNTER_COUNT; id++) {
+        tracks[id].count = 0;
+        tracks[id].head = 0;
+    }
+}
+
+void CounterRates::record(const CounterSample& sample, uint32_t time) {
+    if (haveTime) {
+        int32_t step = (int32_t)(time - lastTime);
+        if (step == 0) {
+            // The same frame over another link
+            return;
+        }
+        if (step < 0) {
+            if (step > -COUNTER_RESET_GAP) {
+                stats.late++;
+                return;
+            }
+            // The sender restarted with a new clock
+            restartHistory();
+            stats.resets++;
+        }
+    }
+    lastTime = time;
+    haveTime = true;
+    stats.samples++;
+
+    for (uint8_t id = 0; id < COUNTER_COUNT; id++) {
+        if (!(sample.mask & (1 << id))) {
+            continue;
+        }
+        Track& track = tracks[id];
+        uint64_t value = sample.values[id];
+
+        if (track.have) {
+            if (value >= track.last) {
+                track.total += value - track.last;
+            } else if (track.last <= 0xFFFFFFFFULL && track.last - value > 0x80000000ULL) {
+                // A 32-bit counter rolled over
+                track.total += value + 0x100000000ULL - track.last;
+                stats.wraps++;
+            } else {
+                // Restarted from zero: everything since counts
+                track.total += value;
+                stats.resets++;
+            }
+        }
+        track.last = value;
+        track.have = true;
+
+        // Fast senders would fill the history in a few seconds: until the
+        // newest sample is COUNTER_BUCKET past the one before it, the next
+        // sample replaces it, so it stays current and the rest spread out
+        uint8_t slot = track.head;
+        if (track.count >= 2) {
+            uint8_t newest = (track.head + COUNTER_HISTORY - 1) % COUNTER_HISTORY;
+            uint8_t previous = (track.head + COUNTER_HISTORY - 2) % COUNTER_HISTORY;
+            if (track.times[newest] - track.times[previous] < COUNTER_BUCKET) {
+                slot = newest;
+            }
+        }
+
+        track.times[slot] = time;
+        track.totals[slot] = track.total;
+        if (slot == track.head) {
+            track.head = (track.head + 1) % COUNTER_HISTORY;
+            if (track.count < COUNTER_HISTORY) {
+                track.count++;
+            }
+        }
+    }
+}
+
+bool CounterRates::getRate(uint8_t id, uint32_t windowMs, float& rate, uint32_t& span) const {
+    if (id >= COUNTER_COUNT || tracks[id].count < 2) {
+        return false;
+    }
+    const Track& track = tracks[id];
+
+    uint8_t newest = (track.head + COUNTER_HISTORY - 1) % COUNTER_HISTORY;
+    uint8_t oldest = (newest + COUNTER_HISTORY - 1) % COUNTER_HISTORY;
+
+    // Walk back while the older sample is still inside the window
+    for (uint8_t i = 2; i < track.count; i++) {
+        uint8_t slot = (newest + COUNTER_HISTORY - i) % COUNTER_HISTORY;
+        if (track.times[newest] - track.times[slot] > windowMs) {
+            break;
+        }
+        oldest = slot;
+    }
+
+    span = track.times[newest] - track.times[oldest];
+    if (span == 0) {
+        return false;
+    }
+    rate = (float)(track.totals[newest] - track.totals[oldest]) * 1000.0f / span;
+    return true;
+}
+
+uint32_t CounterRates::fill(SystemData& data) const {
+    uint32_t fields = 0;
+    float rate;
+    uint32_t span;
+    if (getRate(COUNTER_NET_TX, COUNTER_RATE_WINDOW, rate, span)) {
+        data.networkUpload = rate / 1024.0f;
+        fields |= FIELD_NETWORK_UPLOAD;
+    }
+    if (getRate(COUNTER_NET_RX, COUNTER_RATE_WINDOW, rate, span)) {
+        data.networkDownload = rate / 1024.0f;
+        fields |= FIELD_NETWORK_DOWNLOAD;
+    }
+    if (getRate(COUNTER_DISK_READ, COUNTER_RATE_WINDOW, rate, span)) {
+        data.diskRead = rate / 1024.0f;
+        fields |= FIELD_DISK_READ;
+    }
+    if (getRate(COUNTER_DISK_WRITE, COUNTER_RATE_WINDOW, rate, span)) {
+        data.diskWrite = rate / 1024.0f;
+        fields |= FIELD_DISK_WRITE;
+    }
+    return fields;
+}
+
+int CounterRates::idFromName(const char* name) {
+    for (uint8_t id = 0; id < COUNTER_COUNT; id++) {
+        if (strcmp(name, counterNames[id]) == 0) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+const char* CounterRates::getName(uint8_t id) {
+    return id < COUNTER_COUNT ? counterNames[id] : "?";
+}
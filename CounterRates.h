@@ -0,0 +1,86 @@
+#ifndef COUNTER_RATES_H
+#define COUNTER_RATES_H
+
+#include <Arduino.h>
+#include "SystemData.h"
+
+#define COUNTER_HISTORY      32      // Samples kept per counter
+#define COUNTER_BUCKET       500     // Least spacing of kept samples (ms); 32 cover 15 s or more
+#define COUNTER_RATE_WINDOW  2000    // Window of the rates put into SystemData (ms)
+#define COUNTER_RESET_GAP    60000   // Sender time going back further restarts the history (ms)
+
+// Raw monotonic counters a sender may carry instead of averaged rates
+enum CounterId : uint8_t {
+    COUNTER_NET_TX = 0,      // Bytes sent, all NICs
+    COUNTER_NET_RX,          // Bytes received
+    COUNTER_DISK_READ,       // Bytes read, all disks
+    COUNTER_DISK_WRITE,      // Bytes written
+    COUNTER_DISK_READ_OPS,   // Read operations
+    COUNTER_DISK_WRITE_OPS,  // Write operations
+    COUNTER_COUNT
+};
+
+// Counter values carried by one frame
+struct CounterSample {
+    uint8_t mask;                     // Bit per CounterId present
+    uint64_t values[COUNTER_COUNT];
+};
+
+struct CounterStats {
+    uint32_t samples;    // Frames with counters recorded
+    uint32_t late;       // Dropped: sender time older than the last sample
+    uint32_t wraps;      // 32-bit counters that rolled over
+    uint32_t resets;     // Counters or sender clocks that restarted
+};
+
+// Derives rates from raw counters. Each counter is kept as a running total
+// corrected for wraps and resets, sampled at the sender's time, so a rate
+// covers exactly the time between the two samples it spans however many
+// frames were lost in between. Shared by all links; copies of a frame
+// arriving on several links carry the same sender time and are dropped.
+class CounterRates {
+public:
+    static CounterRates& getInstance();
+
+    // Record a frame's counters taken at the given sender time (ms)
+    void record(const CounterSample& sample, uint32_t time);
+
+    // Per-second rate over the last windowMs, spanning at least the last
+    // two samples; span is the time it actually covers, which is shorter
+    // than the window when the history doesn't reach back that far. False
+    // until a counter has two samples.
+    bool getRate(uint8_t id, uint32_t windowMs, float& rate, uint32_t& span) const;
+
+    // Fill the SystemData rates the counters cover; returns their FIELD_* bits
+    uint32_t fill(SystemData& data) const;
+
+    uint64_t getTotal(uint8_t id) const { return tracks[id].total; }
+    bool hasCounter(uint8_t id) const { return tracks[id].have; }
+    const CounterStats& getStats() const { return stats; }
+    void clear();
+
+    static int idFromName(const char* name);
+    static const char* getName(uint8_t id);
+
+private:
+    CounterRates();
+
+    struct Track {
+        bool have;
+        uint64_t last;                     // Raw value last received
+        uint64_t total;                    // Running total, wraps and resets corrected
+        uint32_t times[COUNTER_HISTORY];   // Sender time of each sample
+        uint64_t totals[COUNTER_HISTORY];
+        uint8_t head;                      // Next slot to write
+        uint8_t count;
+    };
+
+    Track tracks[COUNTER_COUNT];
+    bool haveTime;
+    uint32_t lastTime;
+    CounterStats stats;
+
+    void restartHistory();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "DataSnapshot.h"
+
+DataSnapshot& DataSnapshot::getInstance() {
+    static DataSnapshot instance;
+    return instance;
+}
+
+DataSnapshot::DataSnapshot() : sequence(0), retries(0) {
+    for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+        groupVersion[group].store(0, std::memory_order_relaxed);
+    }
+}
+
+void DataSnapshot::publish(const SystemData& data) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    uint32_t version = (seq >> 1) + 1;
+
+    // Odd while writing: readers of the current buffer are unaffected, but
+    // one that started before the previous publish may now be torn
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    buffers[version & 1] = data;
+    for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+        if (data.dirtyGroups & GROUP_BIT(group)) {
+            groupVersion[group].store(version, std::memory_order_relaxed);
+        }
+    }
+
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+uint32_t DataSnapshot::read(SystemData& out) const {
+    return view([&out](const SystemData& data) { out = data; });
+}
+
+uint8_t DataSnapshot::changedSince(uint32_t version) const {
+    if (version == 0) {
+        return GROUP_MASK_ALL;
+    }
+    uint8_t groups = 0;
+    for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+        if (groupVersion[group].load(std::memory_order_relaxed) > version) {
+            groups |= GROUP_BIT(group);
+        }
+    }
+    return groups;
+}
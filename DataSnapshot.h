@@ -0,0 +1,60 @@
+#ifndef DATA_SNAPSHOT_H
+#define DATA_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "SystemData.h"
+
+// The latest SystemData, published once per applied frame and read by the
+// display, the web server and the CLI.
+//
+// A seqlock over two buffers: the writer fills the spare buffer and then
+// makes it current, so readers use the current one in place while the next
+// version is written. A read is torn only if two publishes start during it;
+// view() detects that from the sequence and reads again. One task may
+// publish; any number may read, without locks.
+class DataSnapshot {
+public:
+    static DataSnapshot& getInstance();
+
+    // Writer: copy data into the spare buffer and make it current. The
+    // groups dirty in data are recorded as changed in the new version.
+    void publish(const SystemData& data);
+
+    // Number of publishes so far; 0 until the first
+    uint32_t getVersion() const { return sequence.load(std::memory_order_acquire) >> 1; }
+
+    // Calls reader with the current snapshot in place, again if a publish
+    // overwrote it meanwhile, so reader must have no side effects beyond
+    // what a repeat overwrites. Returns the version read.
+    template <typename Reader>
+    uint32_t view(Reader reader) const {
+        for (;;) {
+            uint32_t seq = sequence.load(std::memory_order_acquire);
+            reader(buffers[(seq >> 1) & 1]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) - (seq & ~1u) <= 2) {
+                return seq >> 1;
+            }
+            retries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Consistent copy for readers that keep the data; returns its version
+    uint32_t read(SystemData& out) const;
+
+    // Field groups changed in the versions after version (all for 0)
+    uint8_t changedSince(uint32_t version) const;
+
+    uint32_t getRetries() const { return retries.load(std::memory_order_relaxed); }
+
+private:
+    DataSnapshot();
+
+    SystemData buffers[2];
+    std::atomic<uint32_t> sequence;           // Odd while a publish is under way
+    std::atomic<uint32_t> groupVersion[GROUP_COUNT];  // Version each group last changed in
+    mutable std::atomic<uint32_t> retries;    // Reads repeated after a publish overlapped
+};
+
+#endif
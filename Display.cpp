@@ -1,12 +1,12 @@
 #include "Display.h"
 #include <SPI.h>
 
-Display::Display() : historyIndex(0), alertActive(false), lastAlertTime(0), hasData(false) {
+Display::Display() : drawnVersion(0), drawnRows(0), gridColumns(0), gridCount(-1), sensorPage(-1),
+                     sensorCount(-1), staleDrawn(0), repaintGroups(GROUP_MASK_ALL),
+                     alertActive(false), lastAlertTime(0), hasData(false) {
     currentTheme = THEME_DEFAULT;
-    memset(cpuHistory, 0, sizeof(cpuHistory));
-    memset(memHistory, 0, sizeof(memHistory));
-    memset(diskHistory, 0, sizeof(diskHistory));
-    lastTimeDisplayed = "";
+    memset(tileLive, 0, sizeof(tileLive));
+    lastTimeDisplayed[0] = '\0';
 }
 
 Display& Display::getInstance() {
@@ -43,13 +43,15 @@ void Display::begin() {
     // Display date/time
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
     tft.setTextSize(1);
-    String dateStr = Config::getInstance().getFormattedDate();
-    String timeStr = Config::getInstance().getFormattedTime();
-    int16_t w = tft.textWidth(dateStr.c_str());
+    char dateStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedDate(dateStr, sizeof(dateStr));
+    char timeStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedTime(timeStr, sizeof(timeStr));
+    int16_t w = tft.textWidth(dateStr);
     int x = (SCREEN_WIDTH - w) / 2;
     tft.setCursor(x, 200);
     tft.println(dateStr);
-    w = tft.textWidth(timeStr.c_str());
+    w = tft.textWidth(timeStr);
     x = (SCREEN_WIDTH - w) / 2;
     tft.setCursor(x, 215);
     tft.println(timeStr);
@@ -57,63 +59,124 @@ void Display::begin() {
     Serial.println("Display initialized");
 }
 
-void Display::update(const SystemData& data) {
+bool Display::update() {
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+    DisplayTheme theme = Config::getInstance().getDisplayTheme();
+
+    // Nothing new to draw; a theme change still is, unless the idle screen is
+    // up. Hosts other than the followed one change grid tiles only.
+    bool tiles = theme == THEME_GRID && currentTheme == THEME_GRID && SourceTable::getInstance().hasDirty();
+    if (snapshot.getVersion() == drawnVersion && !tiles && (theme == currentTheme || !hasData)) {
+        return false;
+    }
     hasData = true;
 
+    // Only the groups changed since the version drawn last are redrawn
+    uint32_t version = snapshot.read(lastData);
+    uint8_t groups = snapshot.changedSince(drawnVersion);
+    drawnVersion = version;
+
     // Check if theme changed
-    DisplayTheme theme = Config::getInstance().getDisplayTheme();
-    if (theme != currentTheme || needsFullRedraw()) {
+    if (theme != currentTheme || (theme != THEME_GRID && needsFullRedraw())) {
         currentTheme = theme;
         tft.fillScreen(COLOR_BG);
+        gridColumns = 0;
+        gridCount = -1;
+        sensorPage = -1;
+        groups = GROUP_MASK_ALL;
     }
 
-    // Update history
-    updateHistory(data);
+    // Optional rows appearing or going away move the rows below them
+    uint8_t rows = optionalRows(lastData);
+    if (rows != drawnRows) {
+        drawnRows = rows;
+        groups = GROUP_MASK_ALL;
+    }
+
+    render(lastData, groups);
+    return true;
+}
+
+void Display::render(const SystemData& data, uint8_t groups) {
+    // Check for alerts; the grid flags them per tile
+    if (currentTheme != THEME_GRID) {
+        checkAlerts(data);
+    }
 
-    // Check for alerts
-    checkAlerts(data);
+    // Groups going stale or fresh again change colour
+    uint8_t stale = data.staleGroups(millis());
+    groups |= (stale ^ staleDrawn) | repaintGroups;
+    staleDrawn = stale;
+    repaintGroups = 0;
 
     // Render based on current theme
     switch (currentTheme) {
         case THEME_MINIMAL:
-            renderThemeMinimal(data);
+            renderThemeMinimal(data, groups);
             break;
         case THEME_GRAPH:
-            renderThemeGraph(data);
+            renderThemeGraph(data, groups);
             break;
         case THEME_COMPACT:
-            renderThemeCompact(data);
+            renderThemeCompact(data, groups);
+            break;
+        case THEME_GRID:
+            renderThemeGrid();
+            break;
+        case THEME_SENSORS:
+            renderThemeSensors(groups);
             break;
         default:
-            renderThemeDefault(data);
+            renderThemeDefault(data, groups);
             break;
     }
+}
+
+uint8_t Display::optionalRows(const SystemData& data) {
+    uint8_t rows = 0;
+    if (data.gpuUsage > 0 || data.gpuTemp > 0) rows |= 0x01;
+    if (data.motherboardTemp > 0 || data.diskTemp > 0) rows |= 0x02;
+    return rows;
+}
 
-    lastData = data;
+uint16_t Display::groupColor(uint8_t groups, uint16_t color) {
+    return (staleDrawn & groups) ? COLOR_OFFLINE : color;
 }
 
 void Display::updateTimeDisplay() {
-    String currentTime = Config::getInstance().getFormattedTime();
+    // Hosts going offline change their tiles without any new data, and so
+    // do field groups going stale
+    if (hasData && currentTheme == THEME_GRID) {
+        renderThemeGrid();
+    } else if (hasData && currentTheme == THEME_SENSORS) {
+        renderThemeSensors(0);
+    } else if (hasData && lastData.staleGroups(millis()) != staleDrawn) {
+        render(lastData, 0);
+    }
+
+    char currentTime[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedTime(currentTime, sizeof(currentTime));
 
     // Only update if time has changed
-    if (currentTime == lastTimeDisplayed) {
+    if (strcmp(currentTime, lastTimeDisplayed) == 0) {
         return;
     }
 
-    lastTimeDisplayed = currentTime;
+    strcpy(lastTimeDisplayed, currentTime);
 
     tft.setTextSize(1);
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
 
     if (!hasData) {
         // Start screen - show date and time centered below "Waiting for data..."
-        String dateStr = Config::getInstance().getFormattedDate();
-        int16_t w = tft.textWidth(dateStr.c_str());
+        char dateStr[FORMATTED_TIME_SIZE];
+        Config::getInstance().getFormattedDate(dateStr, sizeof(dateStr));
+        int16_t w = tft.textWidth(dateStr);
         int x = (SCREEN_WIDTH - w) / 2;
         tft.fillRect(0, 200, SCREEN_WIDTH, 30, COLOR_BG);
         tft.setCursor(x, 200);
         tft.println(dateStr);
-        w = tft.textWidth(currentTime.c_str());
+        w = tft.textWidth(currentTime);
         x = (SCREEN_WIDTH - w) / 2;
         tft.setCursor(x, 215);
         tft.println(currentTime);
@@ -125,8 +188,9 @@ void Display::updateTimeDisplay() {
             case THEME_MINIMAL:
             case THEME_COMPACT: {
                 // For minimal and compact, time is shown with date in center
-                String dateTimeStr = Config::getInstance().getFormattedDateTime();
-                int16_t w = tft.textWidth(dateTimeStr.c_str());
+                char dateTimeStr[FORMATTED_TIME_SIZE];
+                Config::getInstance().getFormattedDateTime(dateTimeStr, sizeof(dateTimeStr));
+                int16_t w = tft.textWidth(dateTimeStr);
                 int x = (SCREEN_WIDTH - w) / 2;
                 int y = (theme == THEME_MINIMAL) ? 10 : 5;
                 tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
@@ -138,7 +202,7 @@ void Display::updateTimeDisplay() {
             case THEME_GRAPH:
             default: {
                 // For default and graph, time is shown in top right
-                int16_t w = tft.textWidth(currentTime.c_str());
+                int16_t w = tft.textWidth(currentTime);
                 tft.fillRect(SCREEN_WIDTH - w - 5, 10, w + 5, 10, COLOR_BG);
                 tft.setCursor(SCREEN_WIDTH - w - 5, 10);
                 tft.print(currentTime);
@@ -185,11 +249,16 @@ void Display::showConnectionInfo(const char* info) {
 
 void Display::clear() {
     tft.fillScreen(COLOR_BG);
+    repaintGroups = GROUP_MASK_ALL;
 }
 
 void Display::showIdleScreen() {
     hasData = false;
     tft.fillScreen(COLOR_BG);
+    gridColumns = 0;  // Redraw every tile and row when data returns
+    gridCount = -1;
+    sensorPage = -1;
+    repaintGroups = GROUP_MASK_ALL;
 
     // Show title
     tft.setTextColor(COLOR_TEXT, COLOR_BG);
@@ -203,17 +272,19 @@ void Display::showIdleScreen() {
     // Display date/time
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
     tft.setTextSize(1);
-    String dateStr = Config::getInstance().getFormattedDate();
-    String timeStr = Config::getInstance().getFormattedTime();
-    int16_t w = tft.textWidth(dateStr.c_str());
+    char dateStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedDate(dateStr, sizeof(dateStr));
+    char timeStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedTime(timeStr, sizeof(timeStr));
+    int16_t w = tft.textWidth(dateStr);
     int x = (SCREEN_WIDTH - w) / 2;
     tft.setCursor(x, 200);
     tft.println(dateStr);
-    w = tft.textWidth(timeStr.c_str());
+    w = tft.textWidth(timeStr);
     x = (SCREEN_WIDTH - w) / 2;
     tft.setCursor(x, 215);
     tft.println(timeStr);
-    lastTimeDisplayed = timeStr;
+    strcpy(lastTimeDisplayed, timeStr);
 
     Serial.println("Display returned to idle screen");
 }
@@ -228,92 +299,103 @@ bool Display::needsFullRedraw() {
     return false;
 }
 
-void Display::renderThemeDefault(const SystemData& data) {
+void Display::renderThemeDefault(const SystemData& data, uint8_t groups) {
     int y = 10;
 
     // Date/Time at top
     tft.setTextSize(1);
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    String timeStr = Config::getInstance().getFormattedTime();
-    int16_t w = tft.textWidth(timeStr.c_str());
+    char timeStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedTime(timeStr, sizeof(timeStr));
+    int16_t w = tft.textWidth(timeStr);
     tft.fillRect(SCREEN_WIDTH - w - 5, y, w + 5, 10, COLOR_BG);
     tft.setCursor(SCREEN_WIDTH - w - 5, y);
     tft.print(timeStr);
     y += 15;
 
     // CPU
-    tft.setTextSize(1);
-    tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    tft.setCursor(5, y);
-    tft.print("CPU:");
-    y += 15;
-    drawProgressBar(5, y, SCREEN_WIDTH - 10, 20, data.cpuUsage, COLOR_CPU);
-    tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    tft.setCursor(10, y + 5);
     char buf[32];
-    sprintf(buf, "%.1f%% | %.1fC", data.cpuUsage, data.cpuTemp);
-    tft.print(buf);
-    y += 30;
+    uint8_t cpuGroups = GROUP_BIT(GROUP_LOAD) | GROUP_BIT(GROUP_THERMAL);
+    if (groups & cpuGroups) {
+        tft.setTextSize(1);
+        tft.setTextColor(COLOR_LABEL, COLOR_BG);
+        tft.setCursor(5, y);
+        tft.print("CPU:");
+        drawProgressBar(5, y + 15, SCREEN_WIDTH - 10, 20, data.cpuUsage, groupColor(cpuGroups, COLOR_CPU));
+        tft.setTextColor(groupColor(cpuGroups, COLOR_TEXT), COLOR_BG);
+        tft.setCursor(10, y + 20);
+        sprintf(buf, "%.1f%% | %.1fC", data.cpuUsage, data.cpuTemp);
+        tft.print(buf);
+    }
+    y += 45;
 
     // Memory
-    tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    tft.setCursor(5, y);
-    tft.print("Memory:");
-    y += 15;
-    drawProgressBar(5, y, SCREEN_WIDTH - 10, 20, data.memoryPercent, COLOR_MEMORY);
-    tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    tft.setCursor(10, y + 5);
-    sprintf(buf, "%.1f/%.1f GB (%.1f%%)", data.memoryUsed, data.memoryTotal, data.memoryPercent);
-    tft.print(buf);
-    y += 30;
+    uint8_t memoryGroups = GROUP_BIT(GROUP_LOAD) | GROUP_BIT(GROUP_CAPACITY);
+    if (groups & memoryGroups) {
+        tft.setTextColor(COLOR_LABEL, COLOR_BG);
+        tft.setCursor(5, y);
+        tft.print("Memory:");
+        drawProgressBar(5, y + 15, SCREEN_WIDTH - 10, 20, data.memoryPercent, groupColor(memoryGroups, COLOR_MEMORY));
+        tft.setTextColor(groupColor(memoryGroups, COLOR_TEXT), COLOR_BG);
+        tft.setCursor(10, y + 20);
+        sprintf(buf, "%.1f/%.1f GB (%.1f%%)", data.memoryUsed, data.memoryTotal, data.memoryPercent);
+        tft.print(buf);
+    }
+    y += 45;
 
     // Disk
-    tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    tft.setCursor(5, y);
-    tft.print("Disk:");
-    y += 15;
-    drawProgressBar(5, y, SCREEN_WIDTH - 10, 20, data.diskPercent, COLOR_DISK);
-    tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    tft.setCursor(10, y + 5);
-    sprintf(buf, "%.1f/%.1f GB (%.1f%%)", data.diskUsed, data.diskTotal, data.diskPercent);
-    tft.print(buf);
-    y += 30;
+    uint8_t diskGroups = GROUP_BIT(GROUP_CAPACITY);
+    if (groups & diskGroups) {
+        tft.setTextColor(COLOR_LABEL, COLOR_BG);
+        tft.setCursor(5, y);
+        tft.print("Disk:");
+        drawProgressBar(5, y + 15, SCREEN_WIDTH - 10, 20, data.diskPercent, groupColor(diskGroups, COLOR_DISK));
+        tft.setTextColor(groupColor(diskGroups, COLOR_TEXT), COLOR_BG);
+        tft.setCursor(10, y + 20);
+        sprintf(buf, "%.1f/%.1f GB (%.1f%%)", data.diskUsed, data.diskTotal, data.diskPercent);
+        tft.print(buf);
+    }
+    y += 45;
 
     // Network
-    tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    tft.setCursor(5, y);
-    tft.print("Network:");
-    y += 15;
-    tft.setTextColor(COLOR_TEXT, COLOR_BG);
-    tft.setCursor(10, y);
-    sprintf(buf, "UP: %.2f KB/s", data.networkUpload);
-    tft.print(buf);
-    y += 15;
-    tft.setCursor(10, y);
-    sprintf(buf, "DN: %.2f KB/s", data.networkDownload);
-    tft.print(buf);
-    y += 25;
-
-    // GPU (if available)
-    if (data.gpuUsage > 0 || data.gpuTemp > 0) {
+    uint8_t networkGroups = GROUP_BIT(GROUP_LOAD);
+    if (groups & networkGroups) {
         tft.setTextColor(COLOR_LABEL, COLOR_BG);
         tft.setCursor(5, y);
-        tft.print("GPU:");
-        y += 15;
-        tft.setTextColor(COLOR_TEXT, COLOR_BG);
-        tft.setCursor(10, y);
-        sprintf(buf, "%.1f%% | %.1fC", data.gpuUsage, data.gpuTemp);
+        tft.print("Network:");
+        tft.setTextColor(groupColor(networkGroups, COLOR_TEXT), COLOR_BG);
+        tft.setCursor(10, y + 15);
+        sprintf(buf, "UP: %.2f KB/s", data.networkUpload);
+        tft.print(buf);
+        tft.setCursor(10, y + 30);
+        sprintf(buf, "DN: %.2f KB/s", data.networkDownload);
         tft.print(buf);
-        y += 20;
+    }
+    y += 55;
+
+    // GPU (if available)
+    uint8_t gpuGroups = GROUP_BIT(GROUP_LOAD) | GROUP_BIT(GROUP_THERMAL);
+    if (data.gpuUsage > 0 || data.gpuTemp > 0) {
+        if (groups & gpuGroups) {
+            tft.setTextColor(COLOR_LABEL, COLOR_BG);
+            tft.setCursor(5, y);
+            tft.print("GPU:");
+            tft.setTextColor(groupColor(gpuGroups, COLOR_TEXT), COLOR_BG);
+            tft.setCursor(10, y + 15);
+            sprintf(buf, "%.1f%% | %.1fC", data.gpuUsage, data.gpuTemp);
+            tft.print(buf);
+        }
+        y += 35;
     }
 
     // Additional Temperatures (if available)
-    if (data.motherboardTemp > 0 || data.diskTemp > 0) {
+    uint8_t tempGroups = GROUP_BIT(GROUP_THERMAL) | GROUP_BIT(GROUP_INFO);
+    if ((data.motherboardTemp > 0 || data.diskTemp > 0) && (groups & tempGroups)) {
         tft.setTextColor(COLOR_LABEL, COLOR_BG);
         tft.setCursor(5, y);
         tft.print("Temps:");
         y += 15;
-        tft.setTextColor(COLOR_TEXT, COLOR_BG);
+        tft.setTextColor(groupColor(tempGroups, COLOR_TEXT), COLOR_BG);
         tft.setCursor(10, y);
 
         if (data.motherboardTemp > 0) {
@@ -332,14 +414,15 @@ void Display::renderThemeDefault(const SystemData& data) {
     }
 }
 
-void Display::renderThemeMinimal(const SystemData& data) {
+void Display::renderThemeMinimal(const SystemData& data, uint8_t groups) {
     int y = 10;
 
     // Date/Time at top
     tft.setTextSize(1);
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    String dateTimeStr = Config::getInstance().getFormattedDateTime();
-    int16_t w = tft.textWidth(dateTimeStr.c_str());
+    char dateTimeStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedDateTime(dateTimeStr, sizeof(dateTimeStr));
+    int16_t w = tft.textWidth(dateTimeStr);
     int x = (SCREEN_WIDTH - w) / 2;
     tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
     tft.setCursor(x, y);
@@ -348,78 +431,93 @@ void Display::renderThemeMinimal(const SystemData& data) {
 
     tft.setTextSize(2);
 
+    // One line per value, each redrawn only with its own group
     char buf[32];
-    sprintf(buf, "CPU: %.0f%%", data.cpuUsage);
-    tft.setTextColor(COLOR_CPU, COLOR_BG);
-    tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
-    tft.setCursor(20, y);
-    tft.print(buf);
+    if (groups & GROUP_BIT(GROUP_LOAD)) {
+        sprintf(buf, "CPU: %.0f%%", data.cpuUsage);
+        tft.setTextColor(groupColor(GROUP_BIT(GROUP_LOAD), COLOR_CPU), COLOR_BG);
+        tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
+        tft.setCursor(20, y);
+        tft.print(buf);
+    }
     y += 40;
 
-    sprintf(buf, "MEM: %.0f%%", data.memoryPercent);
-    tft.setTextColor(COLOR_MEMORY, COLOR_BG);
-    tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
-    tft.setCursor(20, y);
-    tft.print(buf);
+    if (groups & GROUP_BIT(GROUP_LOAD)) {
+        sprintf(buf, "MEM: %.0f%%", data.memoryPercent);
+        tft.setTextColor(groupColor(GROUP_BIT(GROUP_LOAD), COLOR_MEMORY), COLOR_BG);
+        tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
+        tft.setCursor(20, y);
+        tft.print(buf);
+    }
     y += 40;
 
-    sprintf(buf, "DISK: %.0f%%", data.diskPercent);
-    tft.setTextColor(COLOR_DISK, COLOR_BG);
-    tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
-    tft.setCursor(20, y);
-    tft.print(buf);
+    if (groups & GROUP_BIT(GROUP_CAPACITY)) {
+        sprintf(buf, "DISK: %.0f%%", data.diskPercent);
+        tft.setTextColor(groupColor(GROUP_BIT(GROUP_CAPACITY), COLOR_DISK), COLOR_BG);
+        tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
+        tft.setCursor(20, y);
+        tft.print(buf);
+    }
     y += 40;
 
-    sprintf(buf, "TEMP: %.0fC", data.cpuTemp);
-    tft.setTextColor(COLOR_ALERT, COLOR_BG);
-    tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
-    tft.setCursor(20, y);
-    tft.print(buf);
+    if (groups & GROUP_BIT(GROUP_THERMAL)) {
+        sprintf(buf, "TEMP: %.0fC", data.cpuTemp);
+        tft.setTextColor(groupColor(GROUP_BIT(GROUP_THERMAL), COLOR_ALERT), COLOR_BG);
+        tft.fillRect(0, y, SCREEN_WIDTH, 25, COLOR_BG);
+        tft.setCursor(20, y);
+        tft.print(buf);
+    }
 }
 
-void Display::renderThemeGraph(const SystemData& data) {
+void Display::renderThemeGraph(const SystemData& data, uint8_t groups) {
     int y = 10;
 
     // Date/Time at top right
     tft.setTextSize(1);
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    String timeStr = Config::getInstance().getFormattedTime();
-    int16_t w = tft.textWidth(timeStr.c_str());
+    char timeStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedTime(timeStr, sizeof(timeStr));
+    int16_t w = tft.textWidth(timeStr);
     tft.fillRect(SCREEN_WIDTH - w - 5, y, w + 5, 10, COLOR_BG);
     tft.setCursor(SCREEN_WIDTH - w - 5, y);
     tft.print(timeStr);
 
-    // CPU Graph
-    tft.setTextSize(1);
-    tft.setTextColor(COLOR_CPU, COLOR_BG);
-    tft.setCursor(5, y);
+    // Every frame adds a history sample, so the graphs move with any group
+    uint8_t loadGroups = GROUP_BIT(GROUP_LOAD);
     char buf[32];
-    sprintf(buf, "CPU: %.1f%%", data.cpuUsage);
-    tft.print(buf);
-    y += 15;
-    drawGraph(5, y, SCREEN_WIDTH - 10, 60, cpuHistory, HISTORY_SIZE, COLOR_CPU);
-    y += 70;
+    if (groups) {
+        // CPU Graph
+        tft.setTextSize(1);
+        tft.setTextColor(groupColor(loadGroups, COLOR_CPU), COLOR_BG);
+        tft.setCursor(5, y);
+        sprintf(buf, "CPU: %.1f%%", data.cpuUsage);
+        tft.print(buf);
+        drawGraph(5, y + 15, SCREEN_WIDTH - 10, 60, HISTORY_CPU, COLOR_CPU);
 
-    // Memory Graph
-    tft.setTextColor(COLOR_MEMORY, COLOR_BG);
-    tft.setCursor(5, y);
-    sprintf(buf, "MEM: %.1f%%", data.memoryPercent);
-    tft.print(buf);
-    y += 15;
-    drawGraph(5, y, SCREEN_WIDTH - 10, 60, memHistory, HISTORY_SIZE, COLOR_MEMORY);
-    y += 70;
+        // Memory Graph
+        tft.setTextColor(groupColor(loadGroups, COLOR_MEMORY), COLOR_BG);
+        tft.setCursor(5, y + 85);
+        sprintf(buf, "MEM: %.1f%%", data.memoryPercent);
+        tft.print(buf);
+        drawGraph(5, y + 100, SCREEN_WIDTH - 10, 60, HISTORY_MEMORY, COLOR_MEMORY);
+    }
+    y += 170;
 
     // Disk info
-    tft.setTextColor(COLOR_DISK, COLOR_BG);
-    tft.setCursor(5, y);
-    sprintf(buf, "DISK: %.1f%% | NET: U%.1f D%.1f KB/s",
-            data.diskPercent, data.networkUpload, data.networkDownload);
-    tft.print(buf);
+    uint8_t diskGroups = GROUP_BIT(GROUP_LOAD) | GROUP_BIT(GROUP_CAPACITY);
+    if (groups & diskGroups) {
+        tft.setTextColor(groupColor(diskGroups, COLOR_DISK), COLOR_BG);
+        tft.setCursor(5, y);
+        sprintf(buf, "DISK: %.1f%% | NET: U%.1f D%.1f KB/s",
+                data.diskPercent, data.networkUpload, data.networkDownload);
+        tft.print(buf);
+    }
     y += 15;
 
     // Temperature info
-    if (data.gpuTemp > 0 || data.motherboardTemp > 0 || data.diskTemp > 0) {
-        tft.setTextColor(COLOR_LABEL, COLOR_BG);
+    uint8_t tempGroups = GROUP_BIT(GROUP_THERMAL) | GROUP_BIT(GROUP_INFO);
+    if ((data.gpuTemp > 0 || data.motherboardTemp > 0 || data.diskTemp > 0) && (groups & tempGroups)) {
+        tft.setTextColor(groupColor(tempGroups, COLOR_LABEL), COLOR_BG);
         tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
         tft.setCursor(5, y);
 
@@ -440,15 +538,16 @@ void Display::renderThemeGraph(const SystemData& data) {
     }
 }
 
-void Display::renderThemeCompact(const SystemData& data) {
+void Display::renderThemeCompact(const SystemData& data, uint8_t groups) {
     tft.setTextSize(1);
     int y = 5;
     char buf[64];
 
     // Date/Time at top center
     tft.setTextColor(COLOR_LABEL, COLOR_BG);
-    String dateTimeStr = Config::getInstance().getFormattedDateTime();
-    int16_t w = tft.textWidth(dateTimeStr.c_str());
+    char dateTimeStr[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedDateTime(dateTimeStr, sizeof(dateTimeStr));
+    int16_t w = tft.textWidth(dateTimeStr);
     int x = (SCREEN_WIDTH - w) / 2;
     tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
     tft.setCursor(x, y);
@@ -456,61 +555,229 @@ void Display::renderThemeCompact(const SystemData& data) {
     y += 15;
 
     // Line 1: CPU
-    sprintf(buf, "CPU:%3.0f%% %4.1fC", data.cpuUsage, data.cpuTemp);
-    drawLabel(5, y, "CPU", buf, COLOR_CPU);
-    drawProgressBar(110, y, 125, 12, data.cpuUsage, COLOR_CPU);
+    uint8_t cpuGroups = GROUP_BIT(GROUP_LOAD) | GROUP_BIT(GROUP_THERMAL);
+    if (groups & cpuGroups) {
+        sprintf(buf, "CPU:%3.0f%% %4.1fC", data.cpuUsage, data.cpuTemp);
+        drawLabel(5, y, "CPU", buf, groupColor(cpuGroups, COLOR_CPU));
+        drawProgressBar(110, y, 125, 12, data.cpuUsage, groupColor(cpuGroups, COLOR_CPU));
+    }
     y += 20;
 
     // Line 2: Memory
-    sprintf(buf, "MEM:%3.0f%% %.1f/%.1fGB", data.memoryPercent, data.memoryUsed, data.memoryTotal);
-    drawLabel(5, y, "MEM", buf, COLOR_MEMORY);
-    drawProgressBar(110, y, 125, 12, data.memoryPercent, COLOR_MEMORY);
+    uint8_t memoryGroups = GROUP_BIT(GROUP_LOAD) | GROUP_BIT(GROUP_CAPACITY);
+    if (groups & memoryGroups) {
+        sprintf(buf, "MEM:%3.0f%% %.1f/%.1fGB", data.memoryPercent, data.memoryUsed, data.memoryTotal);
+        drawLabel(5, y, "MEM", buf, groupColor(memoryGroups, COLOR_MEMORY));
+        drawProgressBar(110, y, 125, 12, data.memoryPercent, groupColor(memoryGroups, COLOR_MEMORY));
+    }
     y += 20;
 
     // Line 3: Disk
-    sprintf(buf, "DSK:%3.0f%% %.0f/%.0fGB", data.diskPercent, data.diskUsed, data.diskTotal);
-    drawLabel(5, y, "DSK", buf, COLOR_DISK);
-    drawProgressBar(110, y, 125, 12, data.diskPercent, COLOR_DISK);
+    uint8_t diskGroups = GROUP_BIT(GROUP_CAPACITY);
+    if (groups & diskGroups) {
+        sprintf(buf, "DSK:%3.0f%% %.0f/%.0fGB", data.diskPercent, data.diskUsed, data.diskTotal);
+        drawLabel(5, y, "DSK", buf, groupColor(diskGroups, COLOR_DISK));
+        drawProgressBar(110, y, 125, 12, data.diskPercent, groupColor(diskGroups, COLOR_DISK));
+    }
     y += 20;
 
     // Line 4: Network
-    sprintf(buf, "NET: U%.1f D%.1f KB/s", data.networkUpload, data.networkDownload);
-    tft.setTextColor(COLOR_NETWORK, COLOR_BG);
-    tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
-    tft.setCursor(5, y);
-    tft.print(buf);
+    uint8_t networkGroups = GROUP_BIT(GROUP_LOAD);
+    if (groups & networkGroups) {
+        sprintf(buf, "NET: U%.1f D%.1f KB/s", data.networkUpload, data.networkDownload);
+        tft.setTextColor(groupColor(networkGroups, COLOR_NETWORK), COLOR_BG);
+        tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
+        tft.setCursor(5, y);
+        tft.print(buf);
+    }
     y += 20;
 
     // Line 5: Additional Temperatures
+    uint8_t tempGroups = GROUP_BIT(GROUP_THERMAL) | GROUP_BIT(GROUP_INFO);
     if (data.motherboardTemp > 0 || data.diskTemp > 0) {
-        tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
+        if (groups & tempGroups) {
+            tft.fillRect(0, y, SCREEN_WIDTH, 12, COLOR_BG);
+            tft.setTextColor(groupColor(tempGroups, COLOR_LABEL), COLOR_BG);
+            tft.setCursor(5, y);
+
+            char tempStr[64] = "";
+            bool first = true;
+
+            if (data.motherboardTemp > 0) {
+                sprintf(buf, "MB:%.0fC", data.motherboardTemp);
+                strcat(tempStr, buf);
+                first = false;
+            }
+
+            if (data.diskTemp > 0) {
+                if (!first) strcat(tempStr, " ");
+                sprintf(buf, "%s:%.0fC", data.diskName[0] ? data.diskName : "DSK", data.diskTemp);
+                strcat(tempStr, buf);
+            }
+
+            tft.print(tempStr);
+        }
+        y += 20;
+    }
+
+    // Small graphs, moved by every frame's history sample
+    if (groups) {
+        y += 10;
+        drawGraph(5, y, SCREEN_WIDTH - 10, 80, HISTORY_CPU, COLOR_CPU);
+        y += 90;
+        drawGraph(5, y, SCREEN_WIDTH - 10, 80, HISTORY_MEMORY, COLOR_MEMORY);
+    }
+}
+
+void Display::renderThemeGrid() {
+    SourceTable& sources = SourceTable::getInstance();
+    unsigned long now = millis();
+    int count = sources.getCount();
+
+    // 2x2 tiles up to 4 hosts, 3x3 up to 9, then 4x4
+    int columns = count <= 4 ? 2 : (count <= 9 ? 3 : 4);
+    if (columns != gridColumns) {
+        gridColumns = columns;
+        tft.fillRect(0, GRID_TOP, SCREEN_WIDTH, GRID_BOTTOM - GRID_TOP, COLOR_BG);
+        sources.markAllDirty();
+    }
+
+    if (count != gridCount) {
+        gridCount = count;
+        char buf[24];
+        sprintf(buf, "Hosts: %d/%d", count, SOURCE_TABLE_SIZE);
+        tft.setTextSize(1);
         tft.setTextColor(COLOR_LABEL, COLOR_BG);
-        tft.setCursor(5, y);
+        tft.fillRect(5, 10, 80, 10, COLOR_BG);
+        tft.setCursor(5, 10);
+        tft.print(buf);
+    }
 
-        char tempStr[64] = "";
-        bool first = true;
+    int tileW = SCREEN_WIDTH / columns;
+    int tileH = (GRID_BOTTOM - GRID_TOP) / columns;
+    for (int slot = 0; slot < count; slot++) {
+        bool live = sources.isLive(slot, now);
+        if (!sources.getEntry(slot).dirty && live == tileLive[slot]) {
+            continue;
+        }
 
-        if (data.motherboardTemp > 0) {
-            sprintf(buf, "MB:%.0fC", data.motherboardTemp);
-            strcat(tempStr, buf);
-            first = false;
+        drawTile(slot, (slot % columns) * tileW, GRID_TOP + (slot / columns) * tileH, tileW, tileH, live);
+        tileLive[slot] = live;
+        sources.clearDirty(slot);
+        yield();
+    }
+}
+
+void Display::renderThemeSensors(uint8_t groups) {
+    MetricRegistry& metrics = MetricRegistry::getInstance();
+    unsigned long now = millis();
+    int count = metrics.getCount();
+    int rows = (GRID_BOTTOM - GRID_TOP) / SENSOR_ROW_HEIGHT;
+    int pages = (count + rows - 1) / rows;
+    int page = pages > 1 ? (now / SENSOR_PAGE_TIME) % pages : 0;
+
+    // A keyframe or a painted-over screen redraws every row
+    bool full = page != sensorPage || groups == GROUP_MASK_ALL;
+    if (page != sensorPage) {
+        sensorPage = page;
+        tft.fillRect(0, GRID_TOP, SCREEN_WIDTH, GRID_BOTTOM - GRID_TOP, COLOR_BG);
+    }
+
+    tft.setTextSize(1);
+    if (count != sensorCount || full) {
+        sensorCount = count;
+        char buf[24];
+        if (pages > 1) {
+            sprintf(buf, "Metrics: %d (%d/%d)", count, page + 1, pages);
+        } else {
+            sprintf(buf, "Metrics: %d", count);
         }
+        tft.setTextColor(COLOR_LABEL, COLOR_BG);
+        tft.fillRect(5, 10, 130, 10, COLOR_BG);
+        tft.setCursor(5, 10);
+        tft.print(buf);
+    }
 
-        if (data.diskTemp > 0) {
-            if (!first) strcat(tempStr, " ");
-            sprintf(buf, "%s:%.0fC", data.diskName[0] ? data.diskName : "DSK", data.diskTemp);
-            strcat(tempStr, buf);
+    char buf[48];
+    for (int id = page * rows; id < count && id < (page + 1) * rows; id++) {
+        const MetricInfo& info = metrics.getInfo(id);
+        bool stale = metrics.isStale(id, now);
+        if (!full && info.updated == sensorDrawn[id] && stale == sensorStale[id]) {
+            continue;
         }
 
-        tft.print(tempStr);
-        y += 20;
+        if (info.updated == 0) {
+            snprintf(buf, sizeof(buf), "%-22.22s%8s", info.name, "--");
+        } else {
+            snprintf(buf, sizeof(buf), "%-22.22s%8.1f %s", info.name, metrics.getValue(id), info.unit);
+        }
+        int y = GRID_TOP + (id - page * rows) * SENSOR_ROW_HEIGHT;
+        tft.setTextColor(stale ? COLOR_OFFLINE : (id < metrics.getBuiltinCount() ? COLOR_TEXT : COLOR_LABEL), COLOR_BG);
+        tft.fillRect(0, y, SCREEN_WIDTH, SENSOR_ROW_HEIGHT, COLOR_BG);
+        tft.setCursor(5, y + 2);
+        tft.print(buf);
+
+        sensorDrawn[id] = info.updated;
+        sensorStale[id] = stale;
     }
+}
+
+void Display::drawTile(int slot, int x, int y, int w, int h, bool live) {
+    const SourceEntry& entry = SourceTable::getInstance().getEntry(slot);
+    const SystemData& data = entry.data;
+    bool hot = data.cpuTemp >= Config::getInstance().getAlertThresholds().cpuTempHigh;
+    char buf[FRAME_SOURCE_SIZE];
+
+    tft.fillRect(x + 1, y + 1, w - 2, h - 2, COLOR_BG);
+    tft.drawRect(x + 1, y + 1, w - 2, h - 2, live ? (hot ? COLOR_ALERT : COLOR_LABEL) : COLOR_OFFLINE);
+
+    // Host ID, cut to the tile width
+    int maxChars = (w - 8) / 6;
+    snprintf(buf, sizeof(buf), "%.*s", maxChars < (int)sizeof(buf) - 1 ? maxChars : (int)sizeof(buf) - 1, entry.id);
+    tft.setTextSize(1);
+    tft.setTextColor(live ? COLOR_TEXT : COLOR_OFFLINE, COLOR_BG);
+    tft.setCursor(x + 4, y + 4);
+    tft.print(buf);
 
-    // Small graphs
-    y += 10;
-    drawGraph(5, y, SCREEN_WIDTH - 10, 80, cpuHistory, HISTORY_SIZE, COLOR_CPU);
-    y += 90;
-    drawGraph(5, y, SCREEN_WIDTH - 10, 80, memHistory, HISTORY_SIZE, COLOR_MEMORY);
+    // CPU and memory, large when the tile has room
+    uint8_t textSize = w >= 80 ? 2 : 1;
+    int textY = y + 16;
+    tft.setTextSize(textSize);
+    tft.setTextColor(!live ? COLOR_OFFLINE : (hot ? COLOR_ALERT : COLOR_CPU), COLOR_BG);
+    tft.setCursor(x + 4, textY);
+    sprintf(buf, "C%3.0f%%", data.cpuUsage);
+    tft.print(buf);
+    textY += 8 * textSize + 4;
+
+    tft.setTextColor(live ? COLOR_MEMORY : COLOR_OFFLINE, COLOR_BG);
+    tft.setCursor(x + 4, textY);
+    sprintf(buf, "M%3.0f%%", data.memoryPercent);
+    tft.print(buf);
+    textY += 8 * textSize + 4;
+
+    // CPU history, oldest sample on the left
+    int graphX = x + 4;
+    int graphW = w - 8;
+    int graphH = y + h - 4 - textY;
+    int n = entry.historyCount;
+    if (n < 2 || graphH < 6) {
+        return;
+    }
+
+    uint16_t color = live ? COLOR_CPU : COLOR_OFFLINE;
+    int first = (entry.historyHead + SOURCE_HISTORY_SIZE - n) % SOURCE_HISTORY_SIZE;
+    int prevX = 0;
+    int prevY = 0;
+    for (int i = 0; i < n; i++) {
+        float value = entry.cpuHistory[(first + i) % SOURCE_HISTORY_SIZE];
+        int px = graphX + i * (graphW - 1) / (n - 1);
+        int py = textY + graphH - 1 - (int)(value * (graphH - 1) / 100);
+        if (i > 0) {
+            tft.drawLine(prevX, prevY, px, py, color);
+        }
+        prevX = px;
+        prevY = py;
+    }
 }
 
 void Display::drawProgressBar(int x, int y, int w, int h, float percent, uint16_t color) {
@@ -522,21 +789,23 @@ void Display::drawProgressBar(int x, int y, int w, int h, float percent, uint16_
     tft.fillRect(x + 1, y + 1, fillWidth - 2, h - 2, color);
 }
 
-void Display::drawGraph(int x, int y, int w, int h, float* history, int size, uint16_t color, float maxVal) {
+void Display::drawGraph(int x, int y, int w, int h, HistoryField field, uint16_t color, float maxVal) {
     tft.drawRect(x, y, w, h, COLOR_TEXT);
     tft.fillRect(x + 1, y + 1, w - 2, h - 2, COLOR_BG);
 
-    if (size <= 1 || w < 10 || h < 10) return;  // Safety check
+    if (w < 10 || h < 10 || w - 2 > SCREEN_WIDTH) return;  // Safety check
 
-    float step = (float)(w - 2) / (float)size;
-    for (int i = 1; i < size; i++) {
+    // One column per pixel over the last HISTORY_WINDOW_MS, newest at the right
+    int columns = w - 2;
+    int first = HistoryStore::getInstance().resample(field, HISTORY_WINDOW_MS, graphColumns, columns);
+
+    for (int i = first + 1; i < columns; i++) {
         // Constrain history values to prevent overflow
-        float val1 = constrain(history[i - 1], 0, maxVal);
-        float val2 = constrain(history[i], 0, maxVal);
+        float val1 = constrain(graphColumns[i - 1], 0, maxVal);
+        float val2 = constrain(graphColumns[i], 0, maxVal);
 
-        // Calculate coordinates with float precision first, then convert
-        int x1 = x + 1 + (int)((i - 1) * step);
-        int x2 = x + 1 + (int)(i * step);
+        int x1 = x + i;
+        int x2 = x + 1 + i;
 
         // Calculate y coordinates safely
         int y1 = y + h - 2 - (int)((val1 * (h - 4)) / maxVal);
@@ -560,14 +829,6 @@ void Display::drawLabel(int x, int y, const char* label, const char* value, uint
     tft.print(value);
 }
 
-void Display::updateHistory(const SystemData& data) {
-    cpuHistory[historyIndex] = data.cpuUsage;
-    memHistory[historyIndex] = data.memoryPercent;
-    diskHistory[historyIndex] = data.diskPercent;
-
-    historyIndex = (historyIndex + 1) % HISTORY_SIZE;
-}
-
 void Display::checkAlerts(const SystemData& data) {
     AlertThresholds thresh = Config::getInstance().getAlertThresholds();
     bool alert = false;
@@ -589,8 +850,9 @@ void Display::checkAlerts(const SystemData& data) {
         lastAlertTime = millis();
         alertActive = true;
     } else if (!alert && alertActive) {
-        // Clear alert
+        // Clear alert; the rows it covered are drawn again
         tft.fillRect(0, 0, SCREEN_WIDTH, 30, COLOR_BG);
         alertActive = false;
+        repaintGroups = GROUP_MASK_ALL;
     }
 }
@@ -4,13 +4,14 @@
 #include <TFT_eSPI.h>
 #include "SystemData.h"
 #include "Config.h"
+#include "HistoryStore.h"
+#include "SourceTable.h"
+#include "MetricRegistry.h"
+#include "DataSnapshot.h"
 
 #define SCREEN_WIDTH 240
 #define SCREEN_HEIGHT 320
 
-// History buffer size for graphs
-#define HISTORY_SIZE 60
-
 // Colors
 #define COLOR_BG        TFT_BLACK
 #define COLOR_TEXT      TFT_WHITE
@@ -20,13 +21,22 @@
 #define COLOR_DISK      TFT_ORANGE
 #define COLOR_NETWORK   TFT_MAGENTA
 #define COLOR_ALERT     TFT_RED
+#define COLOR_OFFLINE   TFT_DARKGREY
+
+// Grid theme: host tiles between the header and the status line
+#define GRID_TOP        22
+#define GRID_BOTTOM     298
+
+// Sensors theme: one row per metric in the same area, paged when they don't fit
+#define SENSOR_ROW_HEIGHT  12
+#define SENSOR_PAGE_TIME   5000   // Time per page (ms)
 
 class Display {
 public:
     static Display& getInstance();
 
     void begin();
-    void update(const SystemData& data);
+    bool update();             // Draw the latest snapshot; false if already drawn
     void updateTimeDisplay();  // Update just the time display
     void showIdleScreen();     // Show idle/waiting screen
     void showStatus(const char* message);
@@ -39,32 +49,51 @@ private:
 
     TFT_eSPI tft;
     DisplayTheme currentTheme;
-    SystemData lastData;
+    SystemData lastData;           // Copy of the snapshot drawn
+    uint32_t drawnVersion;         // Its version, 0 before any
+    uint8_t drawnRows;             // optionalRows() as drawn
+
+    // Graph columns resampled from HistoryStore
+    float graphColumns[SCREEN_WIDTH];
+
+    // Grid theme: tiles are redrawn only when their host changed
+    int gridColumns;               // Current layout, 0 forces a full redraw
+    int gridCount;                 // Hosts shown in the header
+    bool tileLive[SOURCE_TABLE_SIZE];  // Liveness as last drawn
+
+    // Sensors theme: rows are redrawn only when their metric changed
+    int sensorPage;                // Page shown, -1 forces a full redraw
+    int sensorCount;               // Metrics shown in the header
+    unsigned long sensorDrawn[METRIC_MAX];  // Update time as last drawn
+    bool sensorStale[METRIC_MAX];
 
-    // History buffers for graphs
-    float cpuHistory[HISTORY_SIZE];
-    float memHistory[HISTORY_SIZE];
-    float diskHistory[HISTORY_SIZE];
-    int historyIndex;
+    // Field groups: rows are redrawn only when one of their groups changed
+    uint8_t staleDrawn;            // Groups drawn as stale
+    uint8_t repaintGroups;         // Groups whose rows were painted over
 
     // Alert state
     bool alertActive;
     unsigned long lastAlertTime;
 
     // Time display state
-    String lastTimeDisplayed;
+    char lastTimeDisplayed[FORMATTED_TIME_SIZE];
     bool hasData;
 
-    void renderThemeDefault(const SystemData& data);
-    void renderThemeMinimal(const SystemData& data);
-    void renderThemeGraph(const SystemData& data);
-    void renderThemeCompact(const SystemData& data);
+    void render(const SystemData& data, uint8_t groups);
+    void renderThemeDefault(const SystemData& data, uint8_t groups);
+    void renderThemeMinimal(const SystemData& data, uint8_t groups);
+    void renderThemeGraph(const SystemData& data, uint8_t groups);
+    void renderThemeCompact(const SystemData& data, uint8_t groups);
+    void renderThemeGrid();
+    void renderThemeSensors(uint8_t groups);
+    void drawTile(int slot, int x, int y, int w, int h, bool live);
 
     void drawProgressBar(int x, int y, int w, int h, float percent, uint16_t color);
-    void drawGraph(int x, int y, int w, int h, float* history, int size, uint16_t color, float maxVal = 100.0);
+    void drawGraph(int x, int y, int w, int h, HistoryField field, uint16_t color, float maxVal = 100.0);
     void drawLabel(int x, int y, const char* label, const char* value, uint16_t color);
-    void updateHistory(const SystemData& data);
     void checkAlerts(const SystemData& data);
+    uint16_t groupColor(uint8_t groups, uint16_t color);  // Greyed while any of groups is stale
+    static uint8_t optionalRows(const SystemData& data);
 
     bool needsFullRedraw();
 };
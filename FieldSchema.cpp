@@ -0,0 +1,205 @@
+#include "FieldSchema.h"
+#include "TextWriter.h"
+
+// Sections in SystemDataSection order; a parent of -1 is a top-level object
+struct SectionInfo {
+    const char* key;
+    const char* label;
+    int8_t parent;
+};
+
+static const SectionInfo sections[SECTION_COUNT] = {
+    {"cpu", "CPU", -1},
+    {"memory", "Memory", -1},
+    {"disk", "Disk", -1},
+    {"network", "Network", -1},
+    {"gpu", "GPU", -1},
+    {"temperatures", "Temperatures", -1},
+    {"disks", "Disks", SECTION_TEMPERATURES},
+};
+
+// The binary format reads the fields in list order, so the list must follow
+// the FIELD_* bits one by one
+#define FIELD_BIT_OF(bit, ...) bit,
+static constexpr uint32_t fieldBits[] = { SYSTEM_DATA_FIELDS(FIELD_BIT_OF, FIELD_BIT_OF) };
+#undef FIELD_BIT_OF
+static constexpr size_t fieldCount = sizeof(fieldBits) / sizeof(fieldBits[0]);
+
+static constexpr bool inBitOrder(size_t i) {
+    return i + 1 >= fieldCount || (fieldBits[i + 1] == fieldBits[i] << 1 && inBitOrder(i + 1));
+}
+
+static_assert(fieldBits[0] == 1 && inBitOrder(0), "SYSTEM_DATA_FIELDS must follow the FIELD_* bit order");
+static_assert(fieldBits[fieldCount - 1] << 1 == FIELD_ALL + 1, "SYSTEM_DATA_FIELDS must list every field");
+
+const char* FieldSchema::sectionKey(uint8_t section) {
+    return section < SECTION_COUNT ? sections[section].key : "";
+}
+
+const char* FieldSchema::sectionLabel(uint8_t section) {
+    return section < SECTION_COUNT ? sections[section].label : "";
+}
+
+uint32_t FieldSchema::sectionFields(uint8_t section) {
+    uint32_t fields = 0;
+#define SECTION_FIELD(bit, member, sect, ...) if (sect == section) fields |= bit;
+    SYSTEM_DATA_FIELDS(SECTION_FIELD, SECTION_FIELD)
+#undef SECTION_FIELD
+    return fields;
+}
+
+uint32_t FieldSchema::readJSON(JsonVariantConst root, SystemData& data) {
+    uint32_t fields = 0;
+
+    // Each section once; parents come before their children
+    JsonVariantConst found[SECTION_COUNT];
+    for (uint8_t section = 0; section < SECTION_COUNT; section++) {
+        const SectionInfo& info = sections[section];
+        if (info.parent < 0) {
+            found[section] = root[info.key];
+            continue;
+        }
+        JsonVariantConst list = found[info.parent][info.key];
+        if (list.is<JsonArrayConst>()) {
+            if (list.size() > 0) {
+                found[section] = list[0];
+            } else {
+                fields |= sectionFields(section);
+            }
+        }
+    }
+
+#define READ_NUMBER(bit, member, section, key, ...) \
+    { \
+        JsonVariantConst value = found[section][key]; \
+        if (!value.isNull()) { data.member = value.as<float>(); fields |= bit; } \
+    }
+#define READ_TEXT(bit, member, section, key, ...) \
+    if (const char* str = found[section][key]) { \
+        strncpy(data.member, str, sizeof(data.member) - 1); \
+        data.member[sizeof(data.member) - 1] = '\0'; \
+        fields |= bit; \
+    }
+    SYSTEM_DATA_FIELDS(READ_NUMBER, READ_TEXT)
+#undef READ_NUMBER
+#undef READ_TEXT
+
+    return fields;
+}
+
+static bool readFloat(const uint8_t*& p, const uint8_t* end, float& out) {
+    if (end - p < 4) {
+        return false;
+    }
+    uint32_t raw = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    memcpy(&out, &raw, sizeof(float));
+    p += 4;
+    return true;
+}
+
+static bool readText(const uint8_t*& p, const uint8_t* end, char* out, size_t size) {
+    if (end - p < 1 || end - p < 1 + p[0]) {
+        return false;
+    }
+    size_t n = p[0] < size - 1 ? p[0] : size - 1;
+    memcpy(out, p + 1, n);
+    out[n] = '\0';
+    p += 1 + p[0];
+    return true;
+}
+
+bool FieldSchema::readBinary(const uint8_t*& p, const uint8_t* end, uint32_t fields, SystemData& data) {
+#define READ_NUMBER(bit, member, ...) \
+    if ((fields & bit) && !readFloat(p, end, data.member)) return false;
+#define READ_TEXT(bit, member, ...) \
+    if ((fields & bit) && !readText(p, end, data.member, sizeof(data.member))) return false;
+    SYSTEM_DATA_FIELDS(READ_NUMBER, READ_TEXT)
+#undef READ_NUMBER
+#undef READ_TEXT
+    return true;
+}
+
+// Members of one section, comma-separated
+static void writeJSONFields(TextWriter& w, const SystemData& data, uint8_t section) {
+    bool first = true;
+#define WRITE_NUMBER(bit, member, sect, key, ...) \
+    if (sect == section) { w.printf("%s\"%s\":%.2f", first ? "" : ",", key, data.member); first = false; }
+#define WRITE_TEXT(bit, member, sect, key, ...) \
+    if (sect == section) { \
+        w.printf("%s\"%s\":\"", first ? "" : ",", key); \
+        w.text(data.member, false); \
+        w.printf("\""); \
+        first = false; \
+    }
+    SYSTEM_DATA_FIELDS(WRITE_NUMBER, WRITE_TEXT)
+#undef WRITE_NUMBER
+#undef WRITE_TEXT
+
+    for (uint8_t child = 0; child < SECTION_COUNT; child++) {
+        if (sections[child].parent == section) {
+            w.printf("%s\"%s\":[{", first ? "" : ",", sections[child].key);
+            writeJSONFields(w, data, child);
+            w.printf("}]");
+            first = false;
+        }
+    }
+}
+
+size_t FieldSchema::writeJSON(const SystemData& data, char* out, size_t size) {
+    TextWriter w(out, size);
+    for (uint8_t section = 0; section < SECTION_COUNT; section++) {
+        if (sections[section].parent < 0) {
+            w.printf("%s\"%s\":{", section ? "," : "", sections[section].key);
+            writeJSONFields(w, data, section);
+            w.printf("}");
+        }
+    }
+    return w.length;
+}
+
+// True if any field of the section (or of a child) is set
+static bool sectionHasData(const SystemData& data, uint8_t section) {
+#define HAS_NUMBER(bit, member, sect, ...) if (sect == section && data.member != 0) return true;
+#define HAS_TEXT(bit, member, sect, ...) if (sect == section && data.member[0] != '\0') return true;
+    SYSTEM_DATA_FIELDS(HAS_NUMBER, HAS_TEXT)
+#undef HAS_NUMBER
+#undef HAS_TEXT
+    for (uint8_t child = 0; child < SECTION_COUNT; child++) {
+        if (sections[child].parent == section && sectionHasData(data, child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void writeHTMLFields(TextWriter& w, const SystemData& data, uint8_t section) {
+#define WRITE_NUMBER(bit, member, sect, key, name, unit, label) \
+    if (sect == section) w.printf("<span class='label'>%s:</span> <span class='value'>%.1f %s</span><br>", label, data.member, unit);
+#define WRITE_TEXT(bit, member, sect, key, label) \
+    if (sect == section && data.member[0] != '\0') { \
+        w.printf("<span class='label'>%s:</span> <span class='value'>", label); \
+        w.text(data.member, true); \
+        w.printf("</span><br>"); \
+    }
+    SYSTEM_DATA_FIELDS(WRITE_NUMBER, WRITE_TEXT)
+#undef WRITE_NUMBER
+#undef WRITE_TEXT
+
+    for (uint8_t child = 0; child < SECTION_COUNT; child++) {
+        if (sections[child].parent == section && sectionHasData(data, child)) {
+            writeHTMLFields(w, data, child);
+        }
+    }
+}
+
+size_t FieldSchema::writeHTML(const SystemData& data, char* out, size_t size) {
+    TextWriter w(out, size);
+    for (uint8_t section = 0; section < SECTION_COUNT; section++) {
+        if (sections[section].parent < 0 && sectionHasData(data, section)) {
+            w.printf("<div class='info'>");
+            writeHTMLFields(w, data, section);
+            w.printf("</div>");
+        }
+    }
+    return w.length;
+}
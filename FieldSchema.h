@@ -0,0 +1,38 @@
+#ifndef FIELD_SCHEMA_H
+#define FIELD_SCHEMA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "SystemData.h"
+
+#define FIELD_SCHEMA_JSON_MAX  768    // Largest writeJSON output, with terminator
+#define FIELD_SCHEMA_HTML_MAX  2048   // Largest writeHTML output, with terminator
+
+// Parsers and writers generated from SYSTEM_DATA_FIELDS. Each handles every
+// field in one pass over the list: a JSON section is looked up once, then
+// each field costs one key lookup. The writers print into a caller's buffer
+// and allocate nothing.
+class FieldSchema {
+public:
+    // Fields present in a frame's JSON; their values are stored in data.
+    // An empty "disks" list clears the fields of that section.
+    static uint32_t readJSON(JsonVariantConst root, SystemData& data);
+
+    // Binary field values for the bits in fields, in bit order; advances p.
+    // False if the payload ends first.
+    static bool readBinary(const uint8_t*& p, const uint8_t* end, uint32_t fields, SystemData& data);
+
+    // Every field as the members of a JSON object, in the shape senders use
+    // ("cpu": {...}, ..., "temperatures": {..., "disks": [{...}]}), without
+    // the enclosing braces. Returns the length; output is cut at size.
+    static size_t writeJSON(const SystemData& data, char* out, size_t size);
+
+    // One block per section that has a non-zero field, one line per field
+    static size_t writeHTML(const SystemData& data, char* out, size_t size);
+
+    static const char* sectionKey(uint8_t section);
+    static const char* sectionLabel(uint8_t section);
+    static uint32_t sectionFields(uint8_t section);
+};
+
+#endif
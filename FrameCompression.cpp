@@ -0,0 +1,122 @@
+#include "FrameCompression.h"
+
+// Keys and names as the PC client writes them; must match
+// COMPRESSION_DICT in pc_app/monitor_client.py byte for byte
+static const char FRAME_DICTIONARY[] =
+    "{\"cpu\":{\"usage\":,\"temp\":,\"name\":\"Intel(R) Core(TM) AMD Ryzen Processor\"},"
+    "\"memory\":{\"used\":,\"total\":,\"percent\":},\"disk\":{\"used\":,\"total\":,\"percent\":},"
+    "\"network\":{\"upload\":,\"download\":},\"gpu\":{\"usage\":,\"temp\":},"
+    "\"temperatures\":{\"cpu\":,\"gpu\":,\"motherboard\":,\"disks\":[{\"name\":\"nvme0n1\",\"temp\":}]},"
+    "\"type\":\"delta\",\"type\":\"key\",\"seq\":,\"ts\":,\"host\":\"\","
+    "\"samples\":{\"fields\":[\"cpu\",\"mem\",\"disk\",\"up\",\"down\"],\"data\":[[-";
+
+static_assert(sizeof(FRAME_DICTIONARY) - 1 <= FRAME_DICTIONARY_MAX, "dictionary exceeds its window space");
+
+FrameDecompressor::FrameDecompressor() : dictionaryLength(sizeof(FRAME_DICTIONARY) - 1) {
+    memset(&stats, 0, sizeof(stats));
+    memcpy(window, FRAME_DICTIONARY, dictionaryLength);
+}
+
+const uint8_t* FrameDecompressor::decompress(const uint8_t* payload, size_t length, size_t& outLength) {
+    if (length < FRAME_COMPRESSED_HEADER || payload[1] != FRAME_DICTIONARY_ID) {
+        stats.errors++;
+        return nullptr;
+    }
+
+    outLength = payload[2] | ((size_t)payload[3] << 8);
+    if (outLength == 0 || outLength > FRAME_DECOMPRESSED_MAX) {
+        stats.errors++;
+        return nullptr;
+    }
+
+    unsigned long start = micros();
+    if (!decodeBlock(payload + FRAME_COMPRESSED_HEADER, length - FRAME_COMPRESSED_HEADER, outLength)) {
+        stats.errors++;
+        return nullptr;
+    }
+    uint32_t elapsed = micros() - start;
+
+    stats.frames++;
+    stats.compressedBytes += length;
+    stats.decompressedBytes += outLength;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) {
+        stats.maxMicros = elapsed;
+    }
+    return window + dictionaryLength;
+}
+
+// Reads a length continued in 255-valued bytes; false if the input ends first
+static bool readLength(const uint8_t*& p, const uint8_t* end, size_t& length) {
+    uint8_t b;
+    do {
+        if (p >= end) {
+            return false;
+        }
+        b = *p++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+bool FrameDecompressor::decodeBlock(const uint8_t* in, size_t length, size_t outLength) {
+    const uint8_t* p = in;
+    const uint8_t* end = in + length;
+    uint8_t* out = window + dictionaryLength;
+    uint8_t* outEnd = out + outLength;
+
+    // Sequences of [token][literals][offset u16][match]; every length and
+    // offset is checked so a corrupt block can't read or write outside
+    while (p < end) {
+        uint8_t token = *p++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(p, end, literals)) {
+            return false;
+        }
+        if (literals > (size_t)(end - p) || literals > (size_t)(outEnd - out)) {
+            return false;
+        }
+        memcpy(out, p, literals);
+        out += literals;
+        p += literals;
+
+        // The last sequence is literals only
+        if (p == end) {
+            break;
+        }
+
+        if (end - p < 2) {
+            return false;
+        }
+        size_t offset = p[0] | ((size_t)p[1] << 8);
+        p += 2;
+        if (offset == 0 || offset > (size_t)(out - window)) {
+            return false;
+        }
+
+        size_t match = token & 0x0F;
+        if (match == 15 && !readLength(p, end, match)) {
+            return false;
+        }
+        match += 4;
+        if (match > (size_t)(outEnd - out)) {
+            return false;
+        }
+
+        // Byte by byte: a match may overlap the bytes it produces
+        const uint8_t* from = out - offset;
+        while (match--) {
+            *out++ = *from++;
+        }
+    }
+    return out == outEnd;
+}
+
+float FrameDecompressor::getRatio() const {
+    return stats.compressedBytes > 0 ? (float)stats.decompressedBytes / stats.compressedBytes : 0.0f;
+}
+
+uint32_t FrameDecompressor::getAverageMicros() const {
+    return stats.frames > 0 ? stats.totalMicros / stats.frames : 0;
+}
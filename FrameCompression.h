@@ -0,0 +1,52 @@
+#ifndef FRAME_COMPRESSION_H
+#define FRAME_COMPRESSION_H
+
+#include <Arduino.h>
+
+// Compressed payload (little-endian):
+//   [0xC1][dictionary id][decompressed length u16][LZ4 block]
+// The block may copy from a static dictionary of the JSON keys, which sits in
+// front of the output as if it had been decoded first. The decompressed
+// payload is an ordinary JSON or binary frame.
+#define FRAME_COMPRESSED_MAGIC  0xC1
+#define FRAME_COMPRESSED_HEADER 4
+#define FRAME_DICTIONARY_ID     1
+#define FRAME_DICTIONARY_MAX    512    // Window space reserved for the dictionary
+#define FRAME_DECOMPRESSED_MAX  2048   // Largest payload after decompression
+
+struct CompressionStats {
+    uint32_t frames;             // Payloads decompressed
+    uint32_t errors;             // Corrupt blocks or unknown dictionaries
+    uint32_t compressedBytes;
+    uint32_t decompressedBytes;
+    uint32_t totalMicros;        // Decompression time, all frames
+    uint32_t maxMicros;
+};
+
+// LZ4 block decoder with a preset dictionary. All state is one fixed window
+// (dictionary + largest payload), so it is not reentrant: use one instance
+// per ingest task.
+class FrameDecompressor {
+public:
+    FrameDecompressor();
+
+    static bool isCompressed(const uint8_t* payload, size_t length) {
+        return length > 0 && payload[0] == FRAME_COMPRESSED_MAGIC;
+    }
+
+    // Decompressed payload, valid until the next call; nullptr on error
+    const uint8_t* decompress(const uint8_t* payload, size_t length, size_t& outLength);
+
+    const CompressionStats& getStats() const { return stats; }
+    float getRatio() const;          // Decompressed per compressed byte
+    uint32_t getAverageMicros() const;
+
+private:
+    uint8_t window[FRAME_DICTIONARY_MAX + FRAME_DECOMPRESSED_MAX];
+    size_t dictionaryLength;
+    CompressionStats stats;
+
+    bool decodeBlock(const uint8_t* in, size_t length, size_t outLength);
+};
+
+#endif
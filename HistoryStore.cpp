@@ -0,0 +1,129 @@
+#include "HistoryStore.h"
+
+HistoryStore::HistoryStore() : head(0), lastTime(0), haveSenderTime(false),
+                               lastSenderTime(0), duplicates(0) {
+}
+
+HistoryStore& HistoryStore::getInstance() {
+    static HistoryStore instance;
+    return instance;
+}
+
+void HistoryStore::valuesFrom(const SystemData& data, float* values) {
+    values[HISTORY_CPU] = data.cpuUsage;
+    values[HISTORY_MEMORY] = data.memoryPercent;
+    values[HISTORY_DISK] = data.diskPercent;
+    values[HISTORY_NET_UP] = data.networkUpload;
+    values[HISTORY_NET_DOWN] = data.networkDownload;
+}
+
+int HistoryStore::fieldFromName(const char* name) {
+    static const char* names[HISTORY_FIELD_COUNT] = {"cpu", "mem", "disk", "up", "down"};
+    for (int i = 0; i < HISTORY_FIELD_COUNT; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool HistoryStore::add(unsigned long time, bool hasSenderTime, uint32_t senderTime, const float* values) {
+    if (hasSenderTime) {
+        // Not newer than the last sample: a copy from another link. A jump back
+        // by more than the window is a different sender clock, so accept it.
+        uint32_t behind = lastSenderTime - senderTime;
+        if (haveSenderTime && behind < HISTORY_WINDOW_MS) {
+            duplicates++;
+            return false;
+        }
+        lastSenderTime = senderTime;
+        haveSenderTime = true;
+    }
+
+    // Keep local times monotonic; latency jitter can reorder batch offsets
+    if (head > 0 && (long)(time - lastTime) < 0) {
+        time = lastTime;
+    }
+
+    // The graphs draw each column's peak, so merging keeps what they show
+    if (head > 0) {
+        HistorySample& newest = samples[(head - 1) & (HISTORY_STORE_SIZE - 1)];
+        if (time - newest.time < HISTORY_SPACING) {
+            for (uint8_t field = 0; field < HISTORY_FIELD_COUNT; field++) {
+                if (values[field] > unpackHistoryValue(newest.values[field])) {
+                    newest.values[field] = packHistoryValue(values[field]);
+                }
+            }
+            lastTime = time;
+            return true;
+        }
+    }
+
+    HistorySample& sample = samples[head & (HISTORY_STORE_SIZE - 1)];
+    sample.time = time;
+    for (uint8_t field = 0; field < HISTORY_FIELD_COUNT; field++) {
+        sample.values[field] = packHistoryValue(values[field]);
+    }
+    lastTime = time;
+    head++;
+    return true;
+}
+
+size_t HistoryStore::resample(HistoryField field, unsigned long windowMs, float* out, size_t columns) {
+    unsigned long start = millis() - windowMs;
+    uint32_t available = head < HISTORY_STORE_SIZE ? head : HISTORY_STORE_SIZE;
+    size_t first = columns;
+    size_t next = 0;       // Next column not yet written
+    float carry = 0;
+    bool haveCarry = false;
+
+    if (columns == 0 || windowMs == 0) {
+        return columns;
+    }
+
+    for (uint32_t i = head - available; i != head; i++) {
+        const HistorySample& sample = samples[i & (HISTORY_STORE_SIZE - 1)];
+        float value = unpackHistoryValue(sample.values[field]);
+
+        if ((long)(sample.time - start) < 0) {
+            carry = value;
+            haveCarry = true;
+            continue;
+        }
+
+        size_t column = (sample.time - start) * columns / windowMs;
+        if (column >= columns) {
+            column = columns - 1;
+        }
+
+        if (column < next) {
+            // Same column as the previous sample: keep the peak
+            if (value > out[column]) {
+                out[column] = value;
+            }
+        } else {
+            for (; next < column; next++) {
+                if (haveCarry) {
+                    out[next] = carry;
+                    if (first == columns) first = next;
+                }
+            }
+            out[column] = value;
+            if (first == columns) first = column;
+            next = column + 1;
+        }
+        carry = value;
+        haveCarry = true;
+    }
+
+    for (; next < columns && haveCarry; next++) {
+        out[next] = carry;
+        if (first == columns) first = next;
+    }
+    return first;
+}
+
+void HistoryStore::clear() {
+    head = 0;
+    haveSenderTime = false;
+}
@@ -0,0 +1,95 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <Arduino.h>
+#include "SystemData.h"
+
+#define HISTORY_STORE_SIZE 512     // Samples kept; power of two
+#define HISTORY_SPACING    120     // Closer samples share one (ms), so the store spans 61 s or more
+#define HISTORY_WINDOW_MS  60000   // Span shown by the graphs
+#define HISTORY_BATCH_MAX  10      // Samples kept per batch frame (1 s at 10 Hz)
+
+// Graphed fields, in batch/binary order
+enum HistoryField {
+    HISTORY_CPU = 0,
+    HISTORY_MEMORY,
+    HISTORY_DISK,
+    HISTORY_NET_UP,
+    HISTORY_NET_DOWN,
+    HISTORY_FIELD_COUNT
+};
+
+// Graphed values are stored as the top half of a float: about 3
+// significant digits, plenty for a graph, in half the space
+inline uint16_t packHistoryValue(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits + 0x8000) >> 16;   // Round to nearest
+}
+
+inline float unpackHistoryValue(uint16_t packed) {
+    uint32_t bits = (uint32_t)packed << 16;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+struct HistorySample {
+    unsigned long time;   // Local millis()
+    uint16_t values[HISTORY_FIELD_COUNT];   // Packed
+};
+
+// Samples carried by one batch frame. Offsets are relative to the frame's
+// send time, so each sample keeps its original spacing.
+struct SampleBatch {
+    uint8_t count;
+    uint8_t fields;       // Bit per HistoryField
+    int16_t offsetMs[HISTORY_BATCH_MAX];
+    uint16_t values[HISTORY_BATCH_MAX][HISTORY_FIELD_COUNT];   // Packed
+
+    void set(uint8_t sample, uint8_t field, float value) { values[sample][field] = packHistoryValue(value); }
+    float get(uint8_t sample, uint8_t field) const { return unpackHistoryValue(values[sample][field]); }
+};
+
+// Sample held by a link until CommManager accepts its update
+struct PendingSample {
+    unsigned long time;
+    float values[HISTORY_FIELD_COUNT];
+    bool hasSenderTime;
+    uint32_t senderTime;
+};
+
+// Timestamped sample history shared by all links, read by the graphs
+class HistoryStore {
+public:
+    static HistoryStore& getInstance();
+
+    // Record a sample. Copies of the same sample arriving on several links
+    // carry the same sender time and are dropped. A sample within
+    // HISTORY_SPACING of the newest is merged into it, keeping the peaks.
+    bool add(unsigned long time, bool hasSenderTime, uint32_t senderTime, const float* values);
+
+    // Resample the last windowMs into columns, keeping the peak of each
+    // column and carrying values across empty ones. Returns the first
+    // column that has data (columns when there is none).
+    size_t resample(HistoryField field, unsigned long windowMs, float* out, size_t columns);
+
+    void clear();
+    uint32_t getCount() const { return head; }
+    uint32_t getDuplicates() const { return duplicates; }
+
+    static void valuesFrom(const SystemData& data, float* values);
+    static int fieldFromName(const char* name);
+
+private:
+    HistoryStore();
+
+    HistorySample samples[HISTORY_STORE_SIZE];
+    uint32_t head;           // Samples written so far
+    unsigned long lastTime;
+    bool haveSenderTime;
+    uint32_t lastSenderTime;
+    uint32_t duplicates;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "LinkStats.h"
+
+// A forward sequence jump larger than this starts a new sender epoch; going
+// back is a restart only when the caller says so
+#define LINK_SEQ_RESTART 1000
+
+LinkStats::LinkStats() {
+    reset();
+}
+
+void LinkStats::reset() {
+    seqStarted = false;
+    baseSeq = 0;
+    highestSeq = 0;
+    seqWindow = 0;
+    epochReceived = 0;
+    totalExpected = 0;
+    totalReceived = 0;
+    duplicates = 0;
+    reordered = 0;
+    restarts = 0;
+
+    haveTransit = false;
+    lastTransit = 0;
+    jitter = 0;
+    offsetMin[0] = INT32_MAX;
+    offsetMin[1] = INT32_MAX;
+    offsetCount = 0;
+    latency = 0;
+    maxLatency = 0;
+}
+
+void LinkStats::record(bool hasSeq, uint32_t seq, bool restart,
+                       bool hasSendTime, uint32_t sendTime, uint32_t recvTime) {
+    // A duplicate's timing says nothing new about the path
+    if (hasSeq && !recordSequence(seq, restart)) {
+        return;
+    }
+    if (hasSendTime) {
+        recordTiming(sendTime, recvTime);
+    }
+}
+
+uint32_t LinkStats::getExpected() const {
+    uint32_t expected = seqStarted ? highestSeq - baseSeq + 1 : 0;
+    return totalExpected + expected;
+}
+
+uint32_t LinkStats::getLost() const {
+    uint32_t expected = getExpected();
+    uint32_t received = getReceived();
+    return expected > received ? expected - received : 0;
+}
+
+float LinkStats::getLossRate() const {
+    uint32_t expected = getExpected();
+    return expected > 0 ? (getLost() * 100.0f) / expected : 0.0f;
+}
+
+bool LinkStats::recordSequence(uint32_t seq, bool restart) {
+    if (!seqStarted) {
+        seqStarted = true;
+        restartSequence(seq);
+        return true;
+    }
+
+    int32_t diff = (int32_t)(seq - highestSeq);
+
+    if (restart || diff > LINK_SEQ_RESTART) {
+        newEpoch(seq);
+        return true;
+    }
+
+    if (diff > 0) {
+        seqWindow = (diff >= LINK_SEQ_WINDOW) ? 0 : (seqWindow << diff);
+        seqWindow |= 1;
+        highestSeq = seq;
+        epochReceived++;
+        return true;
+    }
+
+    int32_t age = -diff;
+    if (age >= LINK_SEQ_WINDOW) {
+        // Too old to tell apart from a duplicate; count it as one
+        duplicates++;
+        return false;
+    }
+
+    uint64_t bit = 1ULL << age;
+    if (seqWindow & bit) {
+        duplicates++;
+        return false;
+    }
+
+    // Late arrival of a frame previously counted as lost
+    seqWindow |= bit;
+    reordered++;
+    epochReceived++;
+    return true;
+}
+
+void LinkStats::newEpoch(uint32_t seq) {
+    // Sender restarted; keep what we know about the previous run
+    totalExpected += highestSeq - baseSeq + 1;
+    totalReceived += epochReceived;
+    restarts++;
+    restartSequence(seq);
+}
+
+void LinkStats::restartSequence(uint32_t seq) {
+    baseSeq = seq;
+    highestSeq = seq;
+    seqWindow = 1;
+    epochReceived = 1;
+}
+
+void LinkStats::recordTiming(uint32_t sendTime, uint32_t recvTime) {
+    // Transit time includes the unknown clock offset; only differences matter
+    int32_t transit = (int32_t)(recvTime - sendTime);
+
+    if (haveTransit) {
+        // RFC 3550: D = (Rj - Ri) - (Sj - Si), J += (|D| - J) / 16
+        int32_t d = transit - lastTransit;
+        if (d < 0) d = -d;
+        jitter += ((float)d - jitter) / 16.0f;
+    }
+    lastTransit = transit;
+
+    // Clock offset: minimum transit over the current and previous bucket, so
+    // the estimate follows slow clock drift
+    if (transit < offsetMin[0]) {
+        offsetMin[0] = transit;
+    }
+    if (++offsetCount >= LINK_OFFSET_BUCKET) {
+        offsetMin[1] = offsetMin[0];
+        offsetMin[0] = transit;
+        offsetCount = 0;
+    }
+    int32_t offset = offsetMin[0] < offsetMin[1] ? offsetMin[0] : offsetMin[1];
+
+    float delay = (float)(transit - offset);
+    latency = haveTransit ? latency + (delay - latency) / 8.0f : delay;
+    if (delay > maxLatency) {
+        maxLatency = delay;
+    }
+
+    haveTransit = true;
+}
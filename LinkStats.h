@@ -0,0 +1,70 @@
+#ifndef LINK_STATS_H
+#define LINK_STATS_H
+
+#include <Arduino.h>
+
+// Sequence window used for duplicate/reorder detection
+#define LINK_SEQ_WINDOW 64
+
+// Frames per bucket of the sliding-minimum clock offset estimator
+#define LINK_OFFSET_BUCKET 64
+
+// End-to-end link quality from sender sequence numbers and send timestamps.
+//
+// Loss, duplicates and reordering are derived from "seq". Jitter follows
+// RFC 3550 (interarrival jitter, 1/16 gain). Sender and device clocks are not
+// synchronized, so one-way latency is estimated against the smallest transit
+// time seen recently (sliding minimum), i.e. the delay added on top of the
+// fastest path.
+class LinkStats {
+public:
+    LinkStats();
+
+    void reset();
+
+    // Record one arrival. Statistics only: the caller decides which frames
+    // are applied, and passes restart when it takes one as a sender restart.
+    void record(bool hasSeq, uint32_t seq, bool restart,
+                bool hasSendTime, uint32_t sendTime, uint32_t recvTime);
+
+    uint32_t getReceived() const { return totalReceived + epochReceived; }
+    uint32_t getExpected() const;
+    uint32_t getLost() const;
+    uint32_t getDuplicates() const { return duplicates; }
+    uint32_t getReordered() const { return reordered; }
+    uint32_t getRestarts() const { return restarts; }
+    float getLossRate() const;      // Percent
+    float getJitter() const { return jitter; }            // ms
+    float getLatency() const { return latency; }          // ms, smoothed
+    float getMaxLatency() const { return maxLatency; }    // ms
+    bool hasTiming() const { return haveTransit; }
+
+private:
+    // Sequence tracking (current sender epoch)
+    bool seqStarted;
+    uint32_t baseSeq;
+    uint32_t highestSeq;
+    uint64_t seqWindow;      // Bit n set: highestSeq - n was received
+    uint32_t epochReceived;
+    uint32_t totalExpected;  // Folded in when the sender restarts
+    uint32_t totalReceived;
+    uint32_t duplicates;
+    uint32_t reordered;
+    uint32_t restarts;
+
+    // Timing
+    bool haveTransit;
+    int32_t lastTransit;
+    float jitter;
+    int32_t offsetMin[2];    // Sliding minimum of transit time over two buckets
+    uint16_t offsetCount;
+    float latency;
+    float maxLatency;
+
+    bool recordSequence(uint32_t seq, bool restart);
+    void recordTiming(uint32_t sendTime, uint32_t recvTime);
+    void restartSequence(uint32_t seq);
+    void newEpoch(uint32_t seq);
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "MetricRegistry.h"
+
+// The numeric SystemData fields, in FIELD_* order
+struct BuiltinMetric {
+    const char* name;
+    const char* unit;
+    uint32_t field;
+    float SystemData::* member;
+};
+
+#define BUILTIN_NUMBER(bit, member, section, key, name, unit, label) {name, unit, bit, &SystemData::member},
+#define BUILTIN_TEXT(...)
+static const BuiltinMetric builtins[] = { SYSTEM_DATA_FIELDS(BUILTIN_NUMBER, BUILTIN_TEXT) };
+#undef BUILTIN_NUMBER
+#undef BUILTIN_TEXT
+
+MetricRegistry& MetricRegistry::getInstance() {
+    static MetricRegistry instance;
+    return instance;
+}
+
+MetricRegistry::MetricRegistry() : seed(0x811C9DC5), count(0), builtinCount(0), rehashes(0), rejected(0) {
+    memset(values, 0, sizeof(values));
+    memset(info, 0, sizeof(info));
+    memset(slots, 0, sizeof(slots));
+
+    for (const BuiltinMetric& builtin : builtins) {
+        int id = intern(builtin.name, builtin.unit, 1.0f);
+        if (id >= 0) {
+            info[id].field = builtin.field;
+        }
+    }
+    builtinCount = count;
+}
+
+uint32_t MetricRegistry::hash(const char* name, uint32_t seed) {
+    // FNV-1a with the seed as offset basis
+    uint32_t h = seed;
+    while (*name) {
+        h ^= (uint8_t)*name++;
+        h *= 16777619UL;
+    }
+    return h ^ (h >> 15);
+}
+
+int MetricRegistry::find(const char* name) const {
+    uint8_t slot = slots[hash(name, seed) & (METRIC_HASH_SLOTS - 1)];
+    if (slot == 0 || strcmp(info[slot - 1].name, name) != 0) {
+        return -1;
+    }
+    return slot - 1;
+}
+
+bool MetricRegistry::rebuild() {
+    // Try seeds until every name lands in a slot of its own
+    for (uint32_t attempt = 0; attempt < METRIC_SEED_TRIES; attempt++) {
+        uint32_t candidate = seed + 0x9E3779B9UL * (attempt + 1);
+        memset(slots, 0, sizeof(slots));
+        bool collision = false;
+        for (uint8_t id = 0; id < count && !collision; id++) {
+            uint8_t& slot = slots[hash(info[id].name, candidate) & (METRIC_HASH_SLOTS - 1)];
+            if (slot != 0) {
+                collision = true;
+            } else {
+                slot = id + 1;
+            }
+        }
+        if (!collision) {
+            seed = candidate;
+            rehashes++;
+            return true;
+        }
+    }
+    return false;
+}
+
+int MetricRegistry::intern(const char* name, const char* unit, float scale) {
+    int id = find(name);
+    if (id < 0) {
+        if (count >= METRIC_MAX || strlen(name) >= METRIC_NAME_SIZE || name[0] == '\0') {
+            rejected++;
+            return -1;
+        }
+
+        id = count++;
+        memset(&info[id], 0, sizeof(info[id]));
+        strcpy(info[id].name, name);
+        info[id].scale = 1.0f;
+        values[id] = 0;
+
+        // Usually the slot is free; otherwise look for a new seed
+        uint8_t& slot = slots[hash(name, seed) & (METRIC_HASH_SLOTS - 1)];
+        if (slot == 0) {
+            slot = id + 1;
+        } else if (!rebuild()) {
+            count--;
+            rebuild();
+            rejected++;
+            return -1;
+        }
+    }
+
+    if (unit) {
+        strncpy(info[id].unit, unit, METRIC_UNIT_SIZE - 1);
+        info[id].unit[METRIC_UNIT_SIZE - 1] = '\0';
+    }
+    if (scale != 0.0f) {
+        info[id].scale = scale;
+    }
+    return id;
+}
+
+void MetricRegistry::set(uint8_t id, float value, unsigned long now) {
+    if (id < count) {
+        values[id] = value * info[id].scale;
+        info[id].updated = now;
+        info[id].listed = true;
+    }
+}
+
+void MetricRegistry::unlistSensors() {
+    for (uint8_t id = builtinCount; id < count; id++) {
+        info[id].listed = false;
+    }
+}
+
+void MetricRegistry::confirmSensors(unsigned long now) {
+    for (uint8_t id = builtinCount; id < count; id++) {
+        if (info[id].listed) {
+            info[id].updated = now;
+        }
+    }
+}
+
+void MetricRegistry::updateFrom(const SystemData& data, uint32_t mask, unsigned long now) {
+    for (uint8_t id = 0; id < builtinCount; id++) {
+        if (mask & info[id].field) {
+            values[id] = data.*(builtins[id].member);
+            info[id].updated = now;
+        }
+    }
+}
+
+bool MetricRegistry::isStale(uint8_t id, unsigned long now) const {
+    uint32_t limit = METRIC_STALE;
+    if (info[id].field) {
+        // Built-in fields age with their group
+        for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+            if (groupFields(group) & info[id].field) {
+                limit = groupStaleAfter(group);
+            }
+        }
+        if (limit == 0) {
+            return false;
+        }
+    }
+    return info[id].updated == 0 || now - info[id].updated > limit;
+}
@@ -0,0 +1,76 @@
+#ifndef METRIC_REGISTRY_H
+#define METRIC_REGISTRY_H
+
+#include <Arduino.h>
+#include "SystemData.h"
+
+#define METRIC_MAX         48      // Metrics held, built-in ones included
+#define METRIC_NAME_SIZE   24      // With terminator
+#define METRIC_UNIT_SIZE   8
+#define METRIC_HASH_SLOTS  256     // Lookup table size; power of two
+#define METRIC_SEED_TRIES  1024    // Seeds tried for a collision-free table
+#define METRIC_STALE       10000   // Age after which a sensor is shown as stale (ms)
+
+struct MetricInfo {
+    char name[METRIC_NAME_SIZE];   // Dotted key, e.g. "cpu.temp" or "fan.cpu"
+    char unit[METRIC_UNIT_SIZE];
+    float scale;                   // Applied to each incoming value
+    uint32_t field;                // FIELD_* bit of a built-in metric, 0 for sensors
+    unsigned long updated;         // Local millis() of the last value, 0 until then
+    bool listed;                   // Sent in the latest keyframe, so deltas confirm it
+};
+
+// Every metric the device knows, by interned ID. The SystemData fields are
+// registered first, in FIELD_* order; sensors a sender names (fans,
+// voltages, further GPUs) are added as they arrive. Values sit in one flat
+// array in ID order. Names resolve through a perfect hash: the seed is
+// chosen so that no two names share a slot, so a lookup is one hash and
+// one compare.
+class MetricRegistry {
+public:
+    static MetricRegistry& getInstance();
+
+    // ID of name, registering it if new. A unit or scale given here
+    // replaces the stored one. -1 when the registry is full or the name too long.
+    int intern(const char* name, const char* unit = nullptr, float scale = 0.0f);
+    int find(const char* name) const;
+
+    // Store a value as received; the metric's scale is applied
+    void set(uint8_t id, float value, unsigned long now);
+
+    // Copy the built-in fields selected by mask from data
+    void updateFrom(const SystemData& data, uint32_t mask, unsigned long now);
+
+    // Deltas leave out sensors that didn't change: a keyframe unlists every
+    // sensor, set() lists the ones it carries, confirmSensors() refreshes them
+    void unlistSensors();
+    void confirmSensors(unsigned long now);
+
+    uint8_t getCount() const { return count; }
+    uint8_t getBuiltinCount() const { return builtinCount; }
+    float getValue(uint8_t id) const { return values[id]; }
+    const float* getValues() const { return values; }
+    const MetricInfo& getInfo(uint8_t id) const { return info[id]; }
+    bool isStale(uint8_t id, unsigned long now) const;
+
+    uint32_t getSeed() const { return seed; }
+    uint32_t getRehashes() const { return rehashes; }
+    uint32_t getRejected() const { return rejected; }
+
+private:
+    MetricRegistry();
+
+    float values[METRIC_MAX];
+    MetricInfo info[METRIC_MAX];
+    uint8_t slots[METRIC_HASH_SLOTS];   // ID + 1, 0 when empty
+    uint32_t seed;
+    uint8_t count;
+    uint8_t builtinCount;
+    uint32_t rehashes;                  // Seeds changed to add a name
+    uint32_t rejected;                  // Names refused: full, too long or no seed found
+
+    static uint32_t hash(const char* name, uint32_t seed);
+    bool rebuild();
+};
+
+#endif
@@ -20,6 +20,8 @@
 #include "CommManager.h"
 #include "Display.h"
 #include "MonitorWebServer.h"
+#include "DataSnapshot.h"
+#include "StaticMemory.h"
 
 // Module instances
 Config& config = Config::getInstance();
@@ -27,8 +29,10 @@ CLI& cli = CLI::getInstance();
 CommManager& comm = CommManager::getInstance();
 Display& display = Display::getInstance();
 MonitorWebServer& webServer = MonitorWebServer::getInstance();
+DataSnapshot& snapshot = DataSnapshot::getInstance();
+StaticMemory& staticMemory = StaticMemory::getInstance();
 
-// System data
+// System data, as merged by the links; readers use the published snapshot
 SystemData systemData;
 unsigned long lastDataTime = 0;
 unsigned long lastDisplayUpdate = 0;
@@ -36,30 +40,53 @@ unsigned long lastTimeUpdate = 0;
 bool inIdleMode = true;  // Start in idle mode
 
 #define DATA_TIMEOUT 5000      // No data timeout (ms)
-#define DISPLAY_UPDATE_RATE 500 // Display update rate (ms)
+#define DISPLAY_UPDATE_RATE 100 // Display update rate (ms); only changed field groups are redrawn
 #define TIME_UPDATE_RATE 1000   // Time display update rate (ms)
+#define RENDER_BUDGET 500       // Render time above which senders are slowed (ms)
+
+// Link notifications: (re)start or stop network services with WiFi
+void onLinkChange(CommInterfaceType link, bool up) {
+    if (link != COMM_WIFI) {
+        return;
+    }
+
+    if (up) {
+        webServer.begin();
+
+        if (inIdleMode) {
+            char info[64];
+            snprintf(info, sizeof(info), "WiFi: %s:%d", WiFi.localIP().toString().c_str(), config.getServerPort());
+            display.showConnectionInfo(info);
+        }
+    } else {
+        webServer.stop();
+        display.showStatus("WiFi lost, reconnecting...");
+    }
+}
 
 void setup() {
     // Initialize configuration
     config.begin();
 
     // Initialize CLI
-    cli.begin(115200);
+    cli.begin(config.getSerialBaud());
     registerCLICommands();
 
     // Initialize display
     display.begin();
     display.showStatus("Initializing...");
 
-    // Initialize communication
+    // Initialize communication (WiFi connects in the background; the web
+    // server is started from onLinkChange once the link is up)
+    comm.setLinkCallback(onLinkChange);
     bool commStarted = comm.begin();
     if (commStarted) {
         display.showStatus("Communication started");
 
-        // Show connection info on startup
-        if (config.getCommInterface() == COMM_WIFI && WiFi.status() == WL_CONNECTED) {
+        // Show connection info of the preferred link on startup
+        if (config.getCommInterface() == COMM_WIFI) {
             char info[64];
-            snprintf(info, sizeof(info), "WiFi: %s:%d", WiFi.localIP().toString().c_str(), config.getServerPort());
+            snprintf(info, sizeof(info), "WiFi: connecting to %s", config.getWiFiSSID().c_str());
             display.showConnectionInfo(info);
         } else if (config.getCommInterface() == COMM_BLE) {
             char info[64];
@@ -68,22 +95,21 @@ void setup() {
         }
     } else {
         display.showStatus("Communication failed!");
-        if (config.getCommInterface() == COMM_WIFI && config.getWiFiSSID().length() == 0) {
-            Serial.println("\n*** WiFi not configured! ***");
-            Serial.println("Use these commands to configure WiFi:");
-            Serial.println("  setwifi <SSID> <password>");
-            Serial.println("  reset");
-            Serial.println("Then restart the device.\n");
-        }
     }
 
-    // Initialize web server (only if using WiFi and connected)
-    if (config.getCommInterface() == COMM_WIFI && commStarted && WiFi.status() == WL_CONNECTED) {
-        webServer.begin();
+    if ((config.getCommLinks() & COMM_LINK_BIT(COMM_WIFI)) && config.getWiFiSSID().length() == 0) {
+        Serial.println("\n*** WiFi not configured! ***");
+        Serial.println("Use these commands to configure WiFi:");
+        Serial.println("  setwifi <SSID> <password>");
+        Serial.println("  reset");
+        Serial.println("Then restart the device.\n");
     }
 
     Serial.println("\n=== System Monitor Ready ===");
     Serial.println("Waiting for data from PC...\n");
+
+    // Everything after this runs from fixed buffers; heap calls are counted
+    staticMemory.seal();
 }
 
 void loop() {
@@ -103,13 +129,20 @@ void loop() {
             Serial.println("Received data, exiting idle mode");
         }
 
-        // Update web server data
-        webServer.setSystemData(systemData);
+        // Display, web server and CLI read it from here
+        snapshot.publish(systemData);
+        systemData.clearDirty();
+    }
 
-        // Update display at controlled rate
-        if (millis() - lastDisplayUpdate >= DISPLAY_UPDATE_RATE) {
-            display.update(systemData);
+    // Update display at controlled rate; the newest snapshot is rendered once
+    // the rate limit allows, and nothing is done if it was already drawn
+    if (millis() - lastDisplayUpdate >= DISPLAY_UPDATE_RATE) {
+        unsigned long renderStart = millis();
+        if (display.update()) {
             lastDisplayUpdate = millis();
+
+            // Senders are throttled when rendering can't keep up (feedback)
+            comm.setRenderTime(lastDisplayUpdate - renderStart, RENDER_BUDGET);
         }
     }
 
@@ -118,8 +151,10 @@ void loop() {
 
     // Update time display periodically
     if (millis() - lastTimeUpdate >= TIME_UPDATE_RATE) {
+        unsigned long renderStart = millis();
         display.updateTimeDisplay();
         lastTimeUpdate = millis();
+        comm.setRenderTime(lastTimeUpdate - renderStart, RENDER_BUDGET);
     }
 
     // Check for idle timeout (return to idle screen)
@@ -140,6 +175,9 @@ void loop() {
         }
     }
 
+    // Report heap calls made since setup (STATIC_MEMORY builds)
+    staticMemory.update();
+
     // Small delay to prevent watchdog issues
     delay(10);
 }
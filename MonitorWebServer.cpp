@@ -1,6 +1,19 @@
 #include "MonitorWebServer.h"
+#include "CommManager.h"
+#include "SourceTable.h"
+#include "CounterRates.h"
+#include "MetricRegistry.h"
+#include "DataSnapshot.h"
+
+static const char* boolText(bool value) {
+    return value ? "true" : "false";
+}
 
-MonitorWebServer::MonitorWebServer() : server(nullptr) {
+MonitorWebServer::MonitorWebServer() : server(nullptr), truncatedPages(0), statusVersion(0), homeVersion(0) {
+    page[0] = '\0';
+    statusFields[0] = '\0';
+    homeFields[0] = '\0';
+    memset(statusGroupUpdated, 0, sizeof(statusGroupUpdated));
 }
 
 MonitorWebServer& MonitorWebServer::getInstance() {
@@ -11,18 +24,28 @@ MonitorWebServer& MonitorWebServer::getInstance() {
 void MonitorWebServer::begin() {
     Config& cfg = Config::getInstance();
 
-    // Only start web server if using WiFi
-    if (cfg.getCommInterface() != COMM_WIFI) {
+    // Only start web server if WiFi is enabled
+    if (!(cfg.getCommLinks() & COMM_LINK_BIT(COMM_WIFI))) {
         Serial.println("Web server disabled (not using WiFi)");
         return;
     }
 
+    // Restarted on every WiFi reconnect; routes are registered only once
+    if (server) {
+        server->begin();
+        Serial.println("Web server restarted on port 80");
+        return;
+    }
+
     server = new WebServer(80);
 
     server->on("/", HTTP_GET, handleRoot);
     server->on("/config", HTTP_GET, handleConfig);
     server->on("/config", HTTP_POST, handleConfigSave);
     server->on("/status", HTTP_GET, handleStatus);
+    server->on("/stats", HTTP_GET, handleStats);
+    server->on("/sources", HTTP_GET, handleSources);
+    server->on("/metrics", HTTP_GET, handleMetrics);
     server->on("/restart", HTTP_GET, handleRestart);
     server->onNotFound(handleNotFound);
 
@@ -30,22 +53,40 @@ void MonitorWebServer::begin() {
     Serial.println("Web server started on port 80");
 }
 
-void MonitorWebServer::update() {
+void MonitorWebServer::stop() {
     if (server) {
-        server->handleClient();
+        server->stop();
     }
 }
 
-void MonitorWebServer::setSystemData(const SystemData& data) {
-    currentData = data;
+void MonitorWebServer::update() {
+    if (server) {
+        server->handleClient();
+    }
 }
 
 void MonitorWebServer::handleRoot() {
-    MonitorWebServer::getInstance().server->send(200, "text/html", generateHomePage());
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    TextWriter w(web.page, sizeof(web.page));
+    writeHomePage(w);
+    web.sendPage(200, "text/html", w);
 }
 
 void MonitorWebServer::handleConfig() {
-    MonitorWebServer::getInstance().server->send(200, "text/html", generateConfigPage());
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    TextWriter w(web.page, sizeof(web.page));
+    writeConfigPage(w);
+    web.sendPage(200, "text/html", w);
+}
+
+void MonitorWebServer::sendPage(int code, const char* contentType, const TextWriter& w) {
+    // A page cut short is broken HTML or JSON; say so instead of sending it
+    if (w.isFull()) {
+        truncatedPages++;
+        server->send(500, "text/plain", "Response too large for WEB_PAGE_SIZE");
+        return;
+    }
+    server->send_P(code, contentType, page, w.length);
 }
 
 void MonitorWebServer::handleConfigSave() {
@@ -58,6 +99,16 @@ void MonitorWebServer::handleConfigSave() {
     if (srv->hasArg("password")) {
         cfg.setWiFiPassword(srv->arg("password").c_str());
     }
+    if (srv->hasArg("multicast")) {
+        // Empty turns multicast off; anything but a multicast address is ignored
+        IPAddress group;
+        String value = srv->arg("multicast");
+        if (value.length() == 0) {
+            cfg.setMulticastGroup(0);
+        } else if (group.fromString(value.c_str()) && WiFiComm::isMulticastAddress(group)) {
+            cfg.setMulticastGroup((uint32_t)group);
+        }
+    }
     if (srv->hasArg("theme")) {
         cfg.setDisplayTheme((DisplayTheme)srv->arg("theme").toInt());
     }
@@ -74,6 +125,12 @@ void MonitorWebServer::handleConfigSave() {
     if (srv->hasArg("idletimeout")) {
         cfg.setIdleTimeout((uint16_t)srv->arg("idletimeout").toInt());
     }
+    if (srv->hasArg("samplems")) {
+        int ms = srv->arg("samplems").toInt();
+        if (ms >= SAMPLE_INTERVAL_MIN && ms <= SAMPLE_INTERVAL_MAX) {
+            cfg.setSampleInterval((uint16_t)ms);
+        }
+    }
 
     srv->send(200, "text/html",
         "<html><body><h1>Configuration Saved</h1>"
@@ -82,17 +139,208 @@ void MonitorWebServer::handleConfigSave() {
 }
 
 void MonitorWebServer::handleStatus() {
-    WebServer* srv = MonitorWebServer::getInstance().server;
-    SystemData& data = MonitorWebServer::getInstance().currentData;
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+
+    // Every field from the schema, written in place from the snapshot
+    if (snapshot.getVersion() != web.statusVersion || web.statusVersion == 0) {
+        web.statusVersion = snapshot.view([&web](const SystemData& data) {
+            FieldSchema::writeJSON(data, web.statusFields, sizeof(web.statusFields));
+            memcpy(web.statusGroupUpdated, data.groupUpdated, sizeof(web.statusGroupUpdated));
+        });
+    }
 
-    String json = "{";
-    json += "\"cpu\":{\"usage\":" + String(data.cpuUsage) + ",\"temp\":" + String(data.cpuTemp) + "},";
-    json += "\"memory\":{\"used\":" + String(data.memoryUsed) + ",\"total\":" + String(data.memoryTotal) + ",\"percent\":" + String(data.memoryPercent) + "},";
-    json += "\"disk\":{\"used\":" + String(data.diskUsed) + ",\"total\":" + String(data.diskTotal) + ",\"percent\":" + String(data.diskPercent) + "},";
-    json += "\"network\":{\"upload\":" + String(data.networkUpload) + ",\"download\":" + String(data.networkDownload) + "}";
-    json += "}";
+    TextWriter w(web.page, sizeof(web.page));
+    w.printf("{%s", web.statusFields);
+
+    // Age of each field group (ms, -1 before it first arrives)
+    unsigned long now = millis();
+    w.print(",\"groups\":{");
+    for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+        unsigned long updated = web.statusGroupUpdated[group];
+        w.printf("%s\"%s\":{\"age\":%ld,\"stale\":%s}", group ? "," : "", groupName(group),
+                 updated ? (long)(now - updated) : -1L, boolText(groupIsStale(group, updated, now)));
+    }
+    w.print("}}");
 
-    srv->send(200, "application/json", json);
+    web.sendPage(200, "application/json", w);
+}
+
+void MonitorWebServer::handleSources() {
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    SourceTable& sources = SourceTable::getInstance();
+    unsigned long now = millis();
+
+    TextWriter w(web.page, sizeof(web.page));
+    w.printf("{\"multiHost\":%s,\"evictions\":%lu,\"hosts\":[",
+             boolText(Config::getInstance().isMultiHost()), sources.getEvictions());
+    for (int i = 0; i < sources.getCount(); i++) {
+        const SourceEntry& entry = sources.getEntry(i);
+        w.print(i > 0 ? ",{\"id\":\"" : "{\"id\":\"");
+        w.text(entry.id, false);
+        w.printf("\",\"link\":\"%s\",\"live\":%s,\"ageMs\":%lu,\"frames\":%lu",
+                 CommManager::getLinkName(entry.link), boolText(sources.isLive(i, now)),
+                 now - entry.lastSeen, entry.frames);
+        w.printf(",\"cpu\":%.2f,\"memory\":%.2f,\"disk\":%.2f,\"cpuTemp\":%.2f}",
+                 entry.data.cpuUsage, entry.data.memoryPercent, entry.data.diskPercent, entry.data.cpuTemp);
+    }
+    w.print("]}");
+
+    web.sendPage(200, "application/json", w);
+}
+
+void MonitorWebServer::handleMetrics() {
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    MetricRegistry& metrics = MetricRegistry::getInstance();
+    unsigned long now = millis();
+
+    TextWriter w(web.page, sizeof(web.page));
+    w.printf("{\"count\":%u,\"builtin\":%u,\"rejected\":%lu,\"metrics\":[",
+             metrics.getCount(), metrics.getBuiltinCount(), metrics.getRejected());
+    for (uint8_t id = 0; id < metrics.getCount(); id++) {
+        const MetricInfo& info = metrics.getInfo(id);
+        w.print(id > 0 ? ",{\"name\":\"" : "{\"name\":\"");
+        w.text(info.name, false);
+        w.print("\",\"unit\":\"");
+        w.text(info.unit, false);
+        if (info.updated == 0) {
+            w.print("\",\"value\":null}");
+            continue;
+        }
+        w.printf("\",\"value\":%.3f,\"ageMs\":%lu,\"stale\":%s}",
+                 metrics.getValue(id), now - info.updated, boolText(metrics.isStale(id, now)));
+    }
+    w.print("]}");
+
+    web.sendPage(200, "application/json", w);
+}
+
+void MonitorWebServer::handleStats() {
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    CommManager& comm = CommManager::getInstance();
+
+    TextWriter w(web.page, sizeof(web.page));
+    w.print("{");
+    const FrameStats* frames = comm.getFrameStats();
+    if (frames) {
+        w.printf("\"frames\":{\"keyframes\":%lu,\"deltas\":%lu,\"gaps\":%lu,\"missed\":%lu",
+                 frames->keyframes, frames->deltas, frames->gaps, frames->missedFrames);
+        w.printf(",\"stale\":%lu,\"coalesced\":%lu,\"overflows\":%lu,\"keyframeNeeded\":%s}",
+                 frames->staleFrames, frames->coalesced, frames->overflows, boolText(frames->keyframeNeeded));
+    }
+    const LinkStats* link = comm.getLinkStats();
+    if (link) {
+        if (frames) w.print(",");
+        w.printf("\"link\":{\"received\":%lu,\"expected\":%lu,\"lost\":%lu,\"lossRate\":%.2f",
+                 link->getReceived(), link->getExpected(), link->getLost(), link->getLossRate());
+        w.printf(",\"duplicates\":%lu,\"reordered\":%lu,\"jitterMs\":%.1f,\"latencyMs\":%.1f",
+                 link->getDuplicates(), link->getReordered(), link->getJitter(), link->getLatency());
+        w.printf(",\"maxLatencyMs\":%.1f}", link->getMaxLatency());
+    }
+    const BLELinkStats* ble = comm.getBLEStats();
+    if (ble) {
+        if (frames || link) w.print(",");
+        w.printf("\"ble\":{\"state\":%d,\"profile\":%d,\"mtu\":%u,\"connections\":%lu",
+                 ble->state, ble->activeProfile, ble->mtu, ble->connections);
+        w.printf(",\"disconnects\":%lu,\"advertisingStarts\":%lu,\"paramUpdates\":%lu,\"writes\":%lu",
+                 ble->disconnects, ble->advertisingStarts, ble->paramUpdates, ble->writes);
+        w.printf(",\"fragments\":%lu,\"reassemblyErrors\":%lu,\"feedbackSent\":%lu",
+                 ble->fragments, ble->reassemblyErrors, ble->feedbackSent);
+        const FrameDecompressor* lz = comm.getBLEDecompressor();
+        if (lz) {
+            const CompressionStats& cs = lz->getStats();
+            w.printf(",\"compression\":{\"frames\":%lu,\"errors\":%lu,\"compressedBytes\":%lu",
+                     cs.frames, cs.errors, cs.compressedBytes);
+            w.printf(",\"decompressedBytes\":%lu,\"ratio\":%.2f,\"avgMicros\":%lu,\"maxMicros\":%lu}",
+                     cs.decompressedBytes, lz->getRatio(), lz->getAverageMicros(), cs.maxMicros);
+        }
+        w.print("}");
+    }
+    const WiFiLinkStats* wifi = comm.getWiFiStats();
+    if (wifi) {
+        if (frames || link || ble) w.print(",");
+        w.printf("\"wifi\":{\"state\":%d,\"attempts\":%lu,\"connects\":%lu,\"disconnects\":%lu",
+                 wifi->state, wifi->attempts, wifi->connects, wifi->disconnects);
+        w.printf(",\"fastConnects\":%lu,\"fastFailures\":%lu,\"lastConnectMs\":%lu,\"bootConnectMs\":%lu",
+                 wifi->fastConnects, wifi->fastFailures, wifi->lastConnectMs, wifi->bootConnectMs);
+        w.print(",\"multicastGroup\":\"");
+        if (wifi->multicastGroup) {
+            IPAddress group(wifi->multicastGroup);
+            w.printf("%u.%u.%u.%u", group[0], group[1], group[2], group[3]);
+        }
+        w.printf("\",\"unicastFrames\":%lu,\"multicastFrames\":%lu,\"feedbackPeers\":%u,\"feedbackSent\":%lu",
+                 wifi->unicastFrames, wifi->multicastFrames, wifi->peers, wifi->feedbackSent);
+        w.printf(",\"fragments\":%lu,\"reassembled\":%lu,\"incomplete\":%lu,\"truncated\":%lu",
+                 wifi->fragments, wifi->reassembled, wifi->incomplete, wifi->truncated);
+        const PlayoutBuffer* playout = comm.getWiFiPlayout();
+        if (playout) {
+            const PlayoutStats& ps = playout->getStats();
+            w.printf(",\"jitterBuffer\":{\"enabled\":%s,\"targetMs\":%lu,\"addedMs\":%.1f",
+                     boolText(Config::getInstance().getJitterBuffer()), ps.targetDelay, ps.averageDelay);
+            w.printf(",\"released\":%lu,\"lateDrops\":%lu,\"lateDropRate\":%.2f,\"early\":%lu,\"resets\":%lu}",
+                     ps.released, ps.lateDrops, playout->getLateDropRate(), ps.early, ps.resets);
+        }
+        w.printf(",\"firstDataMs\":%lu}", comm.getFirstDataTime());
+    }
+    const TcpLinkStats* tcp = comm.getTcpStats();
+    if (tcp) {
+        if (frames || link || ble || wifi) w.print(",");
+        w.printf("\"tcp\":{\"listening\":%s,\"connected\":%s,\"accepts\":%lu,\"replaced\":%lu",
+                 boolText(tcp->listening), boolText(tcp->clientConnected), tcp->accepts, tcp->replaced);
+        w.printf(",\"disconnects\":%lu,\"stalls\":%lu,\"peakBuffered\":%lu,\"protocolErrors\":%lu",
+                 tcp->disconnects, tcp->stalls, tcp->peakBuffered, tcp->protocolErrors);
+        w.printf(",\"decodeErrors\":%lu,\"feedbackSent\":%lu}", tcp->decodeErrors, tcp->feedbackSent);
+    }
+    const SerialLinkStats* serial = comm.getSerialStats();
+    if (serial) {
+        if (frames || link || ble || wifi || tcp) w.print(",");
+        w.printf("\"serial\":{\"frames\":%lu,\"cobsErrors\":%lu,\"crcErrors\":%lu",
+                 serial->frames, serial->cobsErrors, serial->crcErrors);
+        w.printf(",\"decodeErrors\":%lu,\"overruns\":%lu}", serial->decodeErrors, serial->overruns);
+    }
+    if (frames || link || ble || wifi || tcp || serial) w.print(",");
+    HistoryStore& history = HistoryStore::getInstance();
+    w.printf("\"history\":{\"samples\":%lu,\"duplicates\":%lu},", history.getCount(), history.getDuplicates());
+
+    // Raw counters: running totals and per-second rates over 1 s and 10 s,
+    // with the span each one actually covers
+    CounterRates& counters = CounterRates::getInstance();
+    const CounterStats& cs = counters.getStats();
+    w.printf("\"counters\":{\"samples\":%lu,\"late\":%lu,\"wraps\":%lu,\"resets\":%lu",
+             cs.samples, cs.late, cs.wraps, cs.resets);
+    for (uint8_t id = 0; id < COUNTER_COUNT; id++) {
+        if (!counters.hasCounter(id)) continue;
+        float rate1 = 0, rate10 = 0;
+        uint32_t span1 = 0, span10 = 0;
+        counters.getRate(id, 1000, rate1, span1);
+        counters.getRate(id, 10000, rate10, span10);
+        w.printf(",\"%s\":{\"total\":%.0f,\"rate1s\":%.1f,\"span1sMs\":%lu,\"rate10s\":%.1f,\"span10sMs\":%lu}",
+                 CounterRates::getName(id), (double)counters.getTotal(id), rate1, span1, rate10, span10);
+    }
+    w.print("},");
+    const CommFeedbackStats& feedback = comm.getFeedbackStats();
+    w.printf("\"feedback\":{\"intervalMs\":%lu,\"desiredMs\":%u,\"budgetMs\":%lu",
+             feedback.requestedInterval, Config::getInstance().getSampleInterval(), feedback.budgetMs);
+    w.printf(",\"overloaded\":%s,\"overloads\":%lu,\"reports\":%lu},",
+             boolText(feedback.overloaded), feedback.overloads, feedback.reports);
+    w.printf("\"activeLink\":\"%s\",\"links\":[", CommManager::getLinkName(comm.getActiveLink()));
+    bool first = true;
+    for (int i = 0; i < COMM_MAX_INTERFACES; i++) {
+        CommInterfaceType type = (CommInterfaceType)i;
+        const CommLinkHealth& health = comm.getHealth(type);
+        if (!health.enabled) continue;
+        if (!first) w.print(",");
+        first = false;
+        w.printf("{\"name\":\"%s\",\"started\":%s,\"quiet\":%s", CommManager::getLinkName(type),
+                 boolText(health.started), boolText(comm.isLinkQuiet(type)));
+        w.printf(",\"updates\":%lu,\"delivered\":%lu,\"duplicates\":%lu,\"failovers\":%lu",
+                 health.updates, health.delivered, health.duplicates, health.failovers);
+        w.printf(",\"periodMs\":%lu,\"frameRate\":%.1f,\"byteRate\":%.0f}",
+                 health.period, health.frameRate, health.byteRate);
+    }
+    w.print("]}");
+
+    web.sendPage(200, "application/json", w);
 }
 
 void MonitorWebServer::handleRestart() {
@@ -107,110 +355,135 @@ void MonitorWebServer::handleNotFound() {
     MonitorWebServer::getInstance().server->send(404, "text/plain", "Not Found");
 }
 
-String MonitorWebServer::generateHomePage() {
-    SystemData& data = MonitorWebServer::getInstance().currentData;
-
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<title>ESP32 System Monitor</title>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-    html += "<style>";
-    html += "body { font-family: Arial; margin: 20px; background: #1a1a1a; color: #fff; }";
-    html += "h1 { color: #4CAF50; }";
-    html += ".info { background: #2a2a2a; padding: 15px; margin: 10px 0; border-radius: 5px; }";
-    html += ".label { color: #4CAF50; font-weight: bold; }";
-    html += ".value { color: #fff; }";
-    html += "a { color: #4CAF50; text-decoration: none; padding: 10px; display: inline-block; }";
-    html += "</style>";
-    html += "<script>";
-    html += "setInterval(function() { location.reload(); }, 2000);";
-    html += "</script>";
-    html += "</head><body>";
-    html += "<h1>ESP32 System Monitor</h1>";
-
-    html += "<div class='info'>";
-    html += "<span class='label'>CPU Usage:</span> <span class='value'>" + String(data.cpuUsage, 1) + "%</span><br>";
-    html += "<span class='label'>CPU Temp:</span> <span class='value'>" + String(data.cpuTemp, 1) + "°C</span>";
-    html += "</div>";
-
-    html += "<div class='info'>";
-    html += "<span class='label'>Memory:</span> <span class='value'>" + String(data.memoryUsed, 1) + " / " + String(data.memoryTotal, 1) + " GB (" + String(data.memoryPercent, 1) + "%)</span>";
-    html += "</div>";
-
-    html += "<div class='info'>";
-    html += "<span class='label'>Disk:</span> <span class='value'>" + String(data.diskUsed, 1) + " / " + String(data.diskTotal, 1) + " GB (" + String(data.diskPercent, 1) + "%)</span>";
-    html += "</div>";
-
-    html += "<div class='info'>";
-    html += "<span class='label'>Network Upload:</span> <span class='value'>" + String(data.networkUpload, 2) + " KB/s</span><br>";
-    html += "<span class='label'>Network Download:</span> <span class='value'>" + String(data.networkDownload, 2) + " KB/s</span>";
-    html += "</div>";
-
-    html += "<div class='info'>";
-    html += "<span class='label'>Date/Time:</span> <span class='value'>" + Config::getInstance().getFormattedDateTime() + "</span>";
-    html += "</div>";
-
-    html += "<br><a href='/config'>Configuration</a> | ";
-    html += "<a href='/status'>JSON Status</a> | ";
-    html += "<a href='/restart'>Restart Device</a>";
-
-    html += "</body></html>";
-    return html;
-}
-
-String MonitorWebServer::generateConfigPage() {
+void MonitorWebServer::writeHomePage(TextWriter& w) {
+    MonitorWebServer& web = MonitorWebServer::getInstance();
+    DataSnapshot& snapshot = DataSnapshot::getInstance();
+
+    w.print("<!DOCTYPE html><html><head>");
+    w.print("<title>ESP32 System Monitor</title>");
+    w.print("<meta name='viewport' content='width=device-width, initial-scale=1'>");
+    w.print("<style>");
+    w.print("body { font-family: Arial; margin: 20px; background: #1a1a1a; color: #fff; }");
+    w.print("h1 { color: #4CAF50; }");
+    w.print(".info { background: #2a2a2a; padding: 15px; margin: 10px 0; border-radius: 5px; }");
+    w.print(".label { color: #4CAF50; font-weight: bold; }");
+    w.print(".value { color: #fff; }");
+    w.print("a { color: #4CAF50; text-decoration: none; padding: 10px; display: inline-block; }");
+    w.print("</style>");
+    w.print("<script>");
+    w.print("setInterval(function() { location.reload(); }, 2000);");
+    w.print("</script>");
+    w.print("</head><body>");
+    w.print("<h1>ESP32 System Monitor</h1>");
+
+    // One block per section of the schema, written in place from the snapshot
+    if (snapshot.getVersion() != web.homeVersion || web.homeVersion == 0) {
+        web.homeVersion = snapshot.view([&web](const SystemData& data) {
+            FieldSchema::writeHTML(data, web.homeFields, sizeof(web.homeFields));
+        });
+    }
+    w.print(web.homeFields);
+
+    // Sensors beyond the fixed fields, as the sender named them
+    MetricRegistry& metrics = MetricRegistry::getInstance();
+    if (metrics.getCount() > metrics.getBuiltinCount()) {
+        w.print("<div class='info'>");
+        for (uint8_t id = metrics.getBuiltinCount(); id < metrics.getCount(); id++) {
+            const MetricInfo& info = metrics.getInfo(id);
+            w.print("<span class='label'>");
+            w.text(info.name, true);
+            w.print(":</span> <span class='value'>");
+            if (info.updated) {
+                w.printf("%.2f ", metrics.getValue(id));
+            } else {
+                w.print("-- ");
+            }
+            w.text(info.unit, true);
+            w.print("</span><br>");
+        }
+        w.print("</div>");
+    }
+
+    char dateTime[FORMATTED_TIME_SIZE];
+    Config::getInstance().getFormattedDateTime(dateTime, sizeof(dateTime));
+    w.print("<div class='info'>");
+    w.printf("<span class='label'>Date/Time:</span> <span class='value'>%s</span>", dateTime);
+    w.print("</div>");
+
+    w.print("<br><a href='/config'>Configuration</a> | ");
+    w.print("<a href='/status'>JSON Status</a> | ");
+    w.print("<a href='/stats'>Link Stats</a> | ");
+    w.print("<a href='/metrics'>Metrics</a> | ");
+    w.print("<a href='/restart'>Restart Device</a>");
+
+    w.print("</body></html>");
+}
+
+void MonitorWebServer::writeConfigPage(TextWriter& w) {
     Config& cfg = Config::getInstance();
 
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<title>Configuration</title>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-    html += "<style>";
-    html += "body { font-family: Arial; margin: 20px; background: #1a1a1a; color: #fff; }";
-    html += "h1 { color: #4CAF50; }";
-    html += "form { background: #2a2a2a; padding: 20px; border-radius: 5px; }";
-    html += "label { display: block; margin: 10px 0 5px; color: #4CAF50; }";
-    html += "input, select { width: 100%; padding: 8px; margin-bottom: 15px; background: #3a3a3a; border: 1px solid #4a4a4a; color: #fff; border-radius: 3px; }";
-    html += "button { background: #4CAF50; color: white; padding: 10px 20px; border: none; border-radius: 5px; cursor: pointer; }";
-    html += "button:hover { background: #45a049; }";
-    html += "a { color: #4CAF50; text-decoration: none; }";
-    html += "</style>";
-    html += "</head><body>";
-    html += "<h1>Configuration</h1>";
-    html += "<form method='POST' action='/config'>";
-
-    html += "<label>WiFi SSID:</label>";
-    html += "<input type='text' name='ssid' value='" + cfg.getWiFiSSID() + "'>";
-
-    html += "<label>WiFi Password:</label>";
-    html += "<input type='password' name='password' value='" + cfg.getWiFiPassword() + "'>";
-
-    html += "<label>Display Theme:</label>";
-    html += "<select name='theme'>";
-    html += "<option value='0'" + String(cfg.getDisplayTheme() == 0 ? " selected" : "") + ">Default</option>";
-    html += "<option value='1'" + String(cfg.getDisplayTheme() == 1 ? " selected" : "") + ">Minimal</option>";
-    html += "<option value='2'" + String(cfg.getDisplayTheme() == 2 ? " selected" : "") + ">Graph</option>";
-    html += "<option value='3'" + String(cfg.getDisplayTheme() == 3 ? " selected" : "") + ">Compact</option>";
-    html += "</select>";
-
-    html += "<label>Brightness (0-255):</label>";
-    html += "<input type='number' name='brightness' min='0' max='255' value='" + String(cfg.getBrightness()) + "'>";
-
-    html += "<label>Date/Time:</label>";
+    w.print("<!DOCTYPE html><html><head>");
+    w.print("<title>Configuration</title>");
+    w.print("<meta name='viewport' content='width=device-width, initial-scale=1'>");
+    w.print("<style>");
+    w.print("body { font-family: Arial; margin: 20px; background: #1a1a1a; color: #fff; }");
+    w.print("h1 { color: #4CAF50; }");
+    w.print("form { background: #2a2a2a; padding: 20px; border-radius: 5px; }");
+    w.print("label { display: block; margin: 10px 0 5px; color: #4CAF50; }");
+    w.print("input, select { width: 100%; padding: 8px; margin-bottom: 15px; background: #3a3a3a; border: 1px solid #4a4a4a; color: #fff; border-radius: 3px; }");
+    w.print("button { background: #4CAF50; color: white; padding: 10px 20px; border: none; border-radius: 5px; cursor: pointer; }");
+    w.print("button:hover { background: #45a049; }");
+    w.print("a { color: #4CAF50; text-decoration: none; }");
+    w.print("</style>");
+    w.print("</head><body>");
+    w.print("<h1>Configuration</h1>");
+    w.print("<form method='POST' action='/config'>");
+
+    w.print("<label>WiFi SSID:</label>");
+    w.print("<input type='text' name='ssid' value='");
+    w.text(cfg.getWiFiSSID().c_str(), true);
+    w.print("'>");
+
+    w.print("<label>WiFi Password:</label>");
+    w.print("<input type='password' name='password' value='");
+    w.text(cfg.getWiFiPassword().c_str(), true);
+    w.print("'>");
+
+    w.print("<label>Multicast Group (empty=off, applies after restart):</label>");
+    w.print("<input type='text' name='multicast' placeholder='239.1.2.3' value='");
+    if (cfg.getMulticastGroup() != 0) {
+        IPAddress group(cfg.getMulticastGroup());
+        w.printf("%u.%u.%u.%u", group[0], group[1], group[2], group[3]);
+    }
+    w.print("'>");
+
+    static const char* const themeNames[] = {"Default", "Minimal", "Graph", "Compact", "Grid", "Sensors"};
+    w.print("<label>Display Theme:</label>");
+    w.print("<select name='theme'>");
+    for (int theme = 0; theme < (int)(sizeof(themeNames) / sizeof(themeNames[0])); theme++) {
+        w.printf("<option value='%d'%s>%s</option>", theme,
+                 cfg.getDisplayTheme() == theme ? " selected" : "", themeNames[theme]);
+    }
+    w.print("</select>");
+
+    w.print("<label>Brightness (0-255):</label>");
+    w.printf("<input type='number' name='brightness' min='0' max='255' value='%u'>", cfg.getBrightness());
+
+    w.print("<label>Date/Time:</label>");
     int year, month, day, hour, minute, second;
     cfg.getDateTime(year, month, day, hour, minute, second);
-    char datetimeBuf[32];
-    sprintf(datetimeBuf, "%04d-%02d-%02dT%02d:%02d:%02d", year, month, day, hour, minute, second);
-    html += "<input type='datetime-local' name='datetime' value='" + String(datetimeBuf) + "'>";
+    w.printf("<input type='datetime-local' name='datetime' value='%04d-%02d-%02dT%02d:%02d:%02d'>",
+             year, month, day, hour, minute, second);
 
-    html += "<label>Idle Timeout (seconds, 0=disabled):</label>";
-    html += "<input type='number' name='idletimeout' min='0' max='65535' value='" + String(cfg.getIdleTimeout()) + "'>";
+    w.print("<label>Idle Timeout (seconds, 0=disabled):</label>");
+    w.printf("<input type='number' name='idletimeout' min='0' max='65535' value='%u'>", cfg.getIdleTimeout());
 
-    html += "<br><button type='submit'>Save Configuration</button>";
-    html += "</form>";
-    html += "<br><a href='/'>Back to Home</a>";
-    html += "</body></html>";
-    return html;
-}
+    w.print("<label>Sample Period asked of senders (ms):</label>");
+    w.printf("<input type='number' name='samplems' min='%d' max='%d' value='%u'>",
+             SAMPLE_INTERVAL_MIN, SAMPLE_INTERVAL_MAX, cfg.getSampleInterval());
 
-String MonitorWebServer::generateStatusPage() {
-    return "See /status endpoint";
+    w.print("<br><button type='submit'>Save Configuration</button>");
+    w.print("</form>");
+    w.print("<br><a href='/'>Back to Home</a>");
+    w.print("</body></html>");
 }
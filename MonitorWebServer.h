@@ -15,33 +15,53 @@
 
 #include "Config.h"
 #include "SystemData.h"
+#include "FieldSchema.h"
+#include "TextWriter.h"
+
+#define WEB_PAGE_SIZE 8192   // Every page and JSON response is built here
 
 class MonitorWebServer {
 public:
     static MonitorWebServer& getInstance();
 
     void begin();
+    void stop();
     void update();
-    void setSystemData(const SystemData& data);
+
+    uint32_t getTruncatedPages() const { return truncatedPages; }
 
 private:
     MonitorWebServer();
 
     WebServer* server;
-    SystemData currentData;
+
+    // Responses are written in place and sent from here, one at a time
+    char page[WEB_PAGE_SIZE];
+    uint32_t truncatedPages;   // Responses cut short at WEB_PAGE_SIZE
+
+    // Field output, regenerated only when the data snapshot has a new version
+    char statusFields[FIELD_SCHEMA_JSON_MAX];
+    unsigned long statusGroupUpdated[GROUP_COUNT];
+    uint32_t statusVersion;
+    char homeFields[FIELD_SCHEMA_HTML_MAX];
+    uint32_t homeVersion;
 
     // Web handlers
     static void handleRoot();
     static void handleConfig();
     static void handleConfigSave();
     static void handleStatus();
+    static void handleStats();
+    static void handleSources();
+    static void handleMetrics();
     static void handleRestart();
     static void handleNotFound();
 
+    void sendPage(int code, const char* contentType, const TextWriter& w);
+
     // HTML page generators
-    static String generateHomePage();
-    static String generateConfigPage();
-    static String generateStatusPage();
+    static void writeHomePage(TextWriter& w);
+    static void writeConfigPage(TextWriter& w);
 };
 
 #endif
@@ -0,0 +1,123 @@
+#include "PlayoutBuffer.h"
+
+PlayoutBuffer::PlayoutBuffer() {
+    memset(&stats, 0, sizeof(stats));
+    reset();
+}
+
+void PlayoutBuffer::reset() {
+    count = 0;
+    used = 0;
+    haveTransit = false;
+    offsetMin[0] = offsetMin[1] = 0;
+    offsetCount = 0;
+    peakExcess = 0;
+    haveReleased = false;
+    lastReleased = 0;
+    stats.targetDelay = PLAYOUT_MIN_DELAY;
+}
+
+uint32_t PlayoutBuffer::updateTransit(int32_t transit) {
+    // Same estimator as LinkStats: the minimum follows slow clock drift
+    if (!haveTransit) {
+        offsetMin[0] = offsetMin[1] = transit;
+        haveTransit = true;
+    }
+    if (transit < offsetMin[0]) {
+        offsetMin[0] = transit;
+    }
+    if (++offsetCount >= PLAYOUT_OFFSET_BUCKET) {
+        offsetMin[1] = offsetMin[0];
+        offsetMin[0] = transit;
+        offsetCount = 0;
+    }
+    int32_t offset = offsetMin[0] < offsetMin[1] ? offsetMin[0] : offsetMin[1];
+    uint32_t excess = transit > offset ? transit - offset : 0;
+
+    // Jump up to a new peak, settle back over PLAYOUT_DECAY frames
+    if (excess > peakExcess) {
+        peakExcess = excess;
+    } else {
+        peakExcess -= (peakExcess - excess) / PLAYOUT_DECAY;
+    }
+    uint32_t target = peakExcess;
+    if (target < PLAYOUT_MIN_DELAY) {
+        target = PLAYOUT_MIN_DELAY;
+    } else if (target > PLAYOUT_MAX_DELAY) {
+        target = PLAYOUT_MAX_DELAY;
+    }
+    stats.targetDelay = target;
+    return excess;
+}
+
+bool PlayoutBuffer::push(const TelemetryFrame& frame) {
+    // A large jump in sender time is a restart; old frames no longer apply
+    if (haveReleased) {
+        int32_t jump = (int32_t)(frame.sendTime - lastReleased);
+        if (jump < -PLAYOUT_RESET_GAP || jump > PLAYOUT_RESET_GAP) {
+            reset();
+            stats.resets++;
+        }
+    }
+
+    uint32_t excess = updateTransit((int32_t)(frame.receivedAt - frame.sendTime));
+
+    // Too late to play in order: a newer frame has already gone out
+    if (haveReleased && (int32_t)(frame.sendTime - lastReleased) <= 0) {
+        stats.lateDrops++;
+        return false;
+    }
+
+    uint8_t slot = 0;
+    while (used & (1 << slot)) {
+        slot++;
+    }
+    used |= 1 << slot;
+    frames[slot] = frame;
+
+    // Played at the fastest path's arrival time plus the target delay
+    playoutAt[slot] = frame.receivedAt - excess + stats.targetDelay;
+
+    // Insert by send time; frames mostly arrive in order, so scan from the end
+    uint8_t pos = count;
+    while (pos > 0 && (int32_t)(frames[order[pos - 1]].sendTime - frame.sendTime) > 0) {
+        order[pos] = order[pos - 1];
+        pos--;
+    }
+    order[pos] = slot;
+    count++;
+    return true;
+}
+
+bool PlayoutBuffer::pop(unsigned long now, TelemetryFrame& out, bool force) {
+    if (count == 0) {
+        return false;
+    }
+
+    uint8_t slot = order[0];
+    if (!force && (long)(now - playoutAt[slot]) < 0) {
+        return false;
+    }
+
+    out = frames[slot];
+    out.playoutDelay = now - out.receivedAt;
+    out.receivedAt = now;
+
+    used &= ~(1 << slot);
+    count--;
+    memmove(order, order + 1, count);
+
+    lastReleased = out.sendTime;
+    haveReleased = true;
+    stats.released++;
+    if (force) {
+        stats.early++;
+    }
+    stats.averageDelay += ((float)out.playoutDelay - stats.averageDelay) / 16.0f;
+    return true;
+}
+
+float PlayoutBuffer::getLateDropRate() const {
+    uint32_t total = stats.released + stats.lateDrops;
+    return total > 0 ? stats.lateDrops * 100.0f / total : 0.0f;
+}
@@ -0,0 +1,66 @@
+#ifndef PLAYOUT_BUFFER_H
+#define PLAYOUT_BUFFER_H
+
+#include "CommInterface.h"
+
+#define PLAYOUT_SIZE           4      // Frames held; a full buffer releases its oldest early
+#define PLAYOUT_MIN_DELAY      40     // Target delay bounds (ms)
+#define PLAYOUT_MAX_DELAY      400
+#define PLAYOUT_DECAY          32     // Frames for the target to settle after a burst
+#define PLAYOUT_OFFSET_BUCKET  64     // Frames per bucket of the clock offset minimum
+#define PLAYOUT_RESET_GAP      5000   // Sender clock jump that restarts the buffer (ms)
+
+struct PlayoutStats {
+    uint32_t released;        // Frames that went through the buffer
+    uint32_t lateDrops;       // Arrived after a newer frame was already released
+    uint32_t early;           // Released ahead of time because the buffer was full
+    uint32_t resets;          // Sender clock jumps (restarts)
+    uint32_t targetDelay;     // Current target (ms)
+    float averageDelay;       // Delay added per frame, smoothed (ms)
+};
+
+// Jitter buffer for timestamped frames. Each frame is held until its sender
+// time, mapped onto the local clock by the smallest recent transit time,
+// plus a target delay, then released in sender-time order. The target
+// follows the recent peak of the transit time above that minimum, so it
+// grows at once with a burst and shrinks slowly after it.
+class PlayoutBuffer {
+public:
+    PlayoutBuffer();
+
+    void reset();
+
+    // Queue a frame with a send time; false if it was dropped as too late
+    bool push(const TelemetryFrame& frame);
+
+    // Oldest frame if its playout time has come (or at once with force)
+    bool pop(unsigned long now, TelemetryFrame& out, bool force = false);
+
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count == PLAYOUT_SIZE; }
+    const PlayoutStats& getStats() const { return stats; }
+    float getLateDropRate() const;   // Percent of frames pushed
+
+private:
+    TelemetryFrame frames[PLAYOUT_SIZE];
+    unsigned long playoutAt[PLAYOUT_SIZE];
+    uint8_t order[PLAYOUT_SIZE];      // Slots by send time, oldest first
+    uint8_t count;
+    uint16_t used;                    // Bit per occupied slot
+
+    // Clock mapping: minimum of (arrival - send time) over two buckets
+    bool haveTransit;
+    int32_t offsetMin[2];
+    uint32_t offsetCount;
+    uint32_t peakExcess;              // Transit above the minimum, recent peak
+
+    bool haveReleased;
+    uint32_t lastReleased;            // Send time of the newest frame released
+
+    PlayoutStats stats;
+
+    // Returns how late this frame is against the fastest recent path (ms)
+    uint32_t updateTransit(int32_t transit);
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "SerialComm.h"
+
+// Decode one COBS block sequence; returns the decoded length, 0 on error
+static size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t read = 0;
+    size_t write = 0;
+
+    while (read < length) {
+        uint8_t code = in[read++];
+        if (code == 0) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (read >= length) {
+                return 0;
+            }
+            out[write++] = in[read++];
+        }
+        if (code != 0xFF && read < length) {
+            out[write++] = 0;
+        }
+    }
+    return write;
+}
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+static uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+SerialComm::SerialComm() : CommInterface(COMM_SERIAL), connected(false) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+SerialComm::~SerialComm() {
+    stop();
+}
+
+bool SerialComm::begin() {
+    Serial.printf("Serial telemetry on the CLI port (%lu baud)\r\n",
+                  Config::getInstance().getSerialBaud());
+    CLI::getInstance().setFrameHandler(onFrame, this);
+    return true;
+}
+
+void SerialComm::onFrame(void* context, const uint8_t* frame, size_t length) {
+    static_cast<SerialComm*>(context)->handleFrame(frame, length);
+}
+
+void SerialComm::handleFrame(const uint8_t* frame, size_t length) {
+    // Called from CLI::update() in loop(); the ring keeps receiveData() uniform
+    size_t n = cobsDecode(frame, length, decoded);
+    if (n <= SERIAL_CRC_SIZE) {
+        stats.cobsErrors++;
+        return;
+    }
+
+    size_t payloadLength = n - SERIAL_CRC_SIZE;
+    uint16_t expected = decoded[payloadLength] | ((uint16_t)decoded[payloadLength + 1] << 8);
+    if (crc16(decoded, payloadLength) != expected) {
+        stats.crcErrors++;
+        return;
+    }
+
+    TelemetryFrame* slot = rxRing.acquire();
+    if (!slot) {
+        return;  // Counted as an overflow by the ring
+    }
+
+    *slot = TelemetryFrame();
+    if (decodePayload(decoded, payloadLength, *slot)) {
+        rxRing.commit();
+        stats.frames++;
+        stats.lastFrameAt = millis();
+    } else {
+        stats.decodeErrors++;
+    }
+}
+
+void SerialComm::update() {
+    stats.overruns = CLI::getInstance().getFrameOverruns();
+
+    // There is no connection on a UART; the link is up while frames arrive
+    bool active = stats.frames > 0 && millis() - stats.lastFrameAt < SERIAL_IDLE_TIMEOUT;
+    if (active != connected) {
+        connected = active;
+        Serial.printf("Serial telemetry %s\r\n", active ? "started" : "stopped");
+        notifyLink(active);
+    }
+}
+
+bool SerialComm::isConnected() {
+    return connected;
+}
+
+bool SerialComm::receiveData(SystemData& data) {
+    // Apply every queued frame in order; only the newest state leaves this call
+    uint32_t received = 0;
+    noteQueueDepth(rxRing.size(), rxRing.capacity());
+    while (TelemetryFrame* frame = rxRing.peek()) {
+        if (applyFrame(*frame, data)) {
+            received++;
+        }
+        rxRing.release();
+    }
+    setOverflows(rxRing.overflows());
+
+    if (received == 0) {
+        return false;
+    }
+
+    countCoalesced(received - 1);
+    return true;
+}
+
+void SerialComm::stop() {
+    CLI::getInstance().setFrameHandler(nullptr, nullptr);
+    connected = false;
+}
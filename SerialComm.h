@@ -0,0 +1,48 @@
+#ifndef SERIAL_COMM_H
+#define SERIAL_COMM_H
+
+#include "CommInterface.h"
+#include "CLI.h"
+#include "SpscRing.h"
+
+// Frames arrive through the CLI demultiplexer as
+//   0x00 COBS(payload, crc16 little-endian) 0x00
+// with CRC-16/CCITT-FALSE over the payload (JSON or binary)
+#define SERIAL_CRC_SIZE     2
+#define SERIAL_RX_RING_SIZE 2
+#define SERIAL_IDLE_TIMEOUT 5000   // ms without a valid frame before the link counts as down
+
+struct SerialLinkStats {
+    uint32_t frames;        // Valid frames received
+    uint32_t cobsErrors;    // Frames that failed COBS decoding or were too short
+    uint32_t crcErrors;
+    uint32_t decodeErrors;  // Payloads that failed to decode
+    uint32_t overruns;      // Frames longer than the CLI frame buffer
+    unsigned long lastFrameAt;
+};
+
+// Wired telemetry over the USB-serial port shared with the CLI
+class SerialComm : public CommInterface {
+public:
+    SerialComm();
+    ~SerialComm();
+
+    bool begin() override;
+    void update() override;
+    bool isConnected() override;
+    bool receiveData(SystemData& data) override;
+    void stop() override;
+
+    const SerialLinkStats& getStats() const { return stats; }
+
+private:
+    SpscRing<TelemetryFrame, SERIAL_RX_RING_SIZE> rxRing;
+    uint8_t decoded[CLI_FRAME_BUFFER];
+    bool connected;
+    SerialLinkStats stats;
+
+    static void onFrame(void* context, const uint8_t* frame, size_t length);
+    void handleFrame(const uint8_t* frame, size_t length);
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "SourceTable.h"
+#include "CommManager.h"
+
+SourceTable::SourceTable() : count(0), evictions(0), staleFrames(0) {
+    clear();
+}
+
+SourceTable& SourceTable::getInstance() {
+    static SourceTable instance;
+    return instance;
+}
+
+int SourceTable::find(const char* id) const {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(entries[i].id, id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SourceTable::allocate(const char* id, unsigned long now) {
+    // Slots fill in order and are only ever reused, so tiles keep their place
+    int slot = count;
+    if (count < SOURCE_TABLE_SIZE) {
+        count++;
+    } else {
+        slot = 0;
+        for (int i = 1; i < SOURCE_TABLE_SIZE; i++) {
+            if ((long)(entries[i].lastSeen - entries[slot].lastSeen) < 0) {
+                slot = i;
+            }
+        }
+        Serial.printf("Source table full, evicting %s for %s\r\n", entries[slot].id, id);
+        evictions++;
+    }
+
+    SourceEntry& entry = entries[slot];
+    entry = SourceEntry();
+    entry.used = true;
+    strncpy(entry.id, id, sizeof(entry.id) - 1);
+    entry.id[sizeof(entry.id) - 1] = '\0';
+    entry.keyframeNeeded = true;
+    entry.firstSeen = now;
+    return slot;
+}
+
+int SourceTable::apply(const TelemetryFrame& frame, CommInterfaceType link) {
+    const char* id = frame.source[0] ? frame.source : CommManager::getLinkName(link);
+    int slot = find(id);
+    if (slot < 0) {
+        slot = allocate(id, frame.receivedAt);
+    }
+    SourceEntry& entry = entries[slot];
+
+    // Same rules as a single stream; a copy from a second link has an equal seq
+    if (frame.hasSeq && entry.haveSeq) {
+        int32_t diff = (int32_t)(frame.seq - entry.lastSeq);
+        if (diff == 0 || (diff < 0 && !frame.keyframe)) {
+            staleFrames++;
+            return -1;
+        }
+        if (diff > 1 + frame.coalesced && !frame.keyframe) {
+            entry.keyframeNeeded = true;
+        }
+    }
+    if (frame.hasSeq) {
+        entry.lastSeq = frame.seq;
+        entry.haveSeq = true;
+    }
+
+    if (frame.keyframe) {
+        entry.data = frame.data;
+        entry.keyframeNeeded = false;
+    } else {
+        entry.data.merge(frame.data, frame.fields);
+    }
+    entry.data.timestamp = frame.receivedAt;
+    entry.data.touch(frame.partial ? frame.fields : FIELD_ALL, frame.fields, frame.receivedAt);
+    entry.lastSeen = frame.receivedAt;
+    entry.link = link;
+    entry.frames++;
+
+    if (frame.batch.count > 0 && (frame.batch.fields & (1 << HISTORY_CPU))) {
+        for (uint8_t i = 0; i < frame.batch.count; i++) {
+            pushHistory(entry, frame.batch.get(i, HISTORY_CPU));
+        }
+    } else {
+        pushHistory(entry, entry.data.cpuUsage);
+    }
+
+    entry.dirty = true;
+    return slot;
+}
+
+void SourceTable::pushHistory(SourceEntry& entry, float cpu) {
+    entry.cpuHistory[entry.historyHead] = (uint8_t)(constrain(cpu, 0.0f, 100.0f) + 0.5f);
+    entry.historyHead = (entry.historyHead + 1) % SOURCE_HISTORY_SIZE;
+    if (entry.historyCount < SOURCE_HISTORY_SIZE) {
+        entry.historyCount++;
+    }
+}
+
+bool SourceTable::isLive(int slot, unsigned long now) const {
+    return entries[slot].used && now - entries[slot].lastSeen < SOURCE_LIVE_TIMEOUT;
+}
+
+bool SourceTable::hasDirty() const {
+    for (int i = 0; i < count; i++) {
+        if (entries[i].dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SourceTable::markAllDirty() {
+    for (int i = 0; i < count; i++) {
+        entries[i].dirty = true;
+    }
+}
+
+void SourceTable::clear() {
+    for (int i = 0; i < SOURCE_TABLE_SIZE; i++) {
+        entries[i] = SourceEntry();
+        entries[i].used = false;
+    }
+    count = 0;
+}
@@ -0,0 +1,63 @@
+#ifndef SOURCE_TABLE_H
+#define SOURCE_TABLE_H
+
+#include "CommInterface.h"
+
+#define SOURCE_TABLE_SIZE    16      // Hosts tracked; the grid shows one tile each
+#define SOURCE_HISTORY_SIZE  32      // CPU samples kept per host for the tile graph
+#define SOURCE_LIVE_TIMEOUT  10000   // ms without a frame before a host is shown offline
+
+// State of one sending host in multi-host mode
+struct SourceEntry {
+    bool used;
+    char id[FRAME_SOURCE_SIZE];   // Host ID from the frame, else sender address or link name
+    CommInterfaceType link;       // Link of the newest frame
+    SystemData data;
+    bool haveSeq;
+    uint32_t lastSeq;
+    bool keyframeNeeded;
+    unsigned long firstSeen;
+    unsigned long lastSeen;
+    uint32_t frames;
+    uint8_t cpuHistory[SOURCE_HISTORY_SIZE];   // Percent
+    uint8_t historyHead;          // Next slot to write
+    uint8_t historyCount;
+    bool dirty;                   // Changed since the tile was last drawn
+};
+
+// Per-host state table for the grid theme. Frames are keyed by source, each
+// host keeps its own keyframe/delta and sequence state, and the least
+// recently seen host is evicted when a new one arrives on a full table.
+class SourceTable {
+public:
+    static SourceTable& getInstance();
+
+    // Merge a frame into its host's entry; returns the slot, or -1 for a
+    // stale or duplicate frame
+    int apply(const TelemetryFrame& frame, CommInterfaceType link);
+
+    const SourceEntry& getEntry(int slot) const { return entries[slot]; }
+    bool isLive(int slot, unsigned long now) const;
+    void clearDirty(int slot) { entries[slot].dirty = false; }
+    bool hasDirty() const;
+    void markAllDirty();
+    void clear();
+
+    int getCount() const { return count; }
+    uint32_t getEvictions() const { return evictions; }
+    uint32_t getStaleFrames() const { return staleFrames; }
+
+private:
+    SourceTable();
+
+    SourceEntry entries[SOURCE_TABLE_SIZE];
+    int count;
+    uint32_t evictions;
+    uint32_t staleFrames;
+
+    int find(const char* id) const;
+    int allocate(const char* id, unsigned long now);
+    void pushHistory(SourceEntry& entry, float cpu);
+};
+
+#endif
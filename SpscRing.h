@@ -0,0 +1,99 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Fixed-slot single-producer/single-consumer ring.
+//
+// Slots are filled and drained in place (acquire/commit on the producer side,
+// peek/release on the consumer side), so no copies or heap use happen on
+// either path. One task may produce and one other task may consume without
+// locks; N must be a power of two.
+//
+// The head and the consumer's claim share one word, so the producer can take
+// back its newest slot (reclaim) only while the consumer hasn't peeked it.
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+    static_assert(N <= 0x8000, "SpscRing indices are 16-bit");
+
+public:
+    SpscRing() : state(0), tail(0), overflowCount(0) {}
+
+    // Producer: next free slot, or nullptr if the ring is full (counted)
+    T* acquire() {
+        uint16_t h = headOf(state.load(std::memory_order_relaxed));
+        if ((uint16_t)(h - tail.load(std::memory_order_acquire)) >= N) {
+            overflowCount.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots[h & (N - 1)];
+    }
+
+    // Producer: publish the slot returned by acquire() or reclaim()
+    void commit() {
+        state.fetch_add(1u << 16, std::memory_order_release);
+    }
+
+    // Producer: unpublish the newest slot so it can be rewritten in place, or
+    // nullptr if nothing is queued or the consumer already peeked it. The
+    // slot keeps its contents; commit() publishes it again.
+    T* reclaim() {
+        uint32_t s = state.load(std::memory_order_relaxed);
+        do {
+            if (headOf(s) == claimOf(s)) {
+                return nullptr;
+            }
+        } while (!state.compare_exchange_weak(s, s - (1u << 16), std::memory_order_acquire,
+                                              std::memory_order_relaxed));
+        return &slots[(uint16_t)(headOf(s) - 1) & (N - 1)];
+    }
+
+    // Producer: every slot is taken
+    bool isFull() const {
+        return (uint16_t)(headOf(state.load(std::memory_order_relaxed)) -
+                          tail.load(std::memory_order_acquire)) >= N;
+    }
+
+    // Consumer: oldest filled slot, or nullptr if empty. Peeking claims the
+    // slot, so the producer can no longer reclaim it.
+    T* peek() {
+        uint16_t t = (uint16_t)tail.load(std::memory_order_relaxed);
+        uint32_t s = state.load(std::memory_order_acquire);
+        if (claimOf(s) != t) {
+            return &slots[t & (N - 1)];   // Already claimed
+        }
+        do {
+            if (headOf(s) == t) {
+                return nullptr;
+            }
+        } while (!state.compare_exchange_weak(s, (s & 0xFFFF0000u) | (uint16_t)(t + 1),
+                                              std::memory_order_acquire, std::memory_order_acquire));
+        return &slots[t & (N - 1)];
+    }
+
+    // Consumer: hand the slot returned by peek() back to the producer
+    void release() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint32_t size() const {
+        return (uint16_t)(headOf(state.load(std::memory_order_acquire)) -
+                          tail.load(std::memory_order_acquire));
+    }
+
+    uint32_t capacity() const { return N; }
+    uint32_t overflows() const { return overflowCount.load(std::memory_order_relaxed); }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> state;   // Head in the high half, consumer claim in the low half
+    std::atomic<uint32_t> tail;   // Compared in its low 16 bits
+    std::atomic<uint32_t> overflowCount;
+
+    static uint16_t headOf(uint32_t s) { return (uint16_t)(s >> 16); }
+    static uint16_t claimOf(uint32_t s) { return (uint16_t)s; }
+};
+
+#endif
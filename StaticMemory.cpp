@@ -0,0 +1,245 @@
+#include "StaticMemory.h"
+#include "CommManager.h"
+#include "CLI.h"
+#include "Display.h"
+#include "MonitorWebServer.h"
+#include "DataSnapshot.h"
+#include "HistoryStore.h"
+#include "SourceTable.h"
+#include "CounterRates.h"
+#include "MetricRegistry.h"
+#include "Config.h"
+#include <esp_heap_caps.h>
+#include <new>
+
+// The singletons and globals that hold every runtime buffer. All are
+// static storage, so the map is known when the firmware is built.
+static constexpr MemoryRegion regions[] = {
+    {"Links (CommManager)", sizeof(CommManager)},
+    {"Display", sizeof(Display)},
+    {"Web server", sizeof(MonitorWebServer)},
+    {"CLI", sizeof(CLI)},
+    {"Data snapshot", sizeof(DataSnapshot)},
+    {"Merged data", sizeof(SystemData)},
+    {"History", sizeof(HistoryStore)},
+    {"Sources", sizeof(SourceTable)},
+    {"Counters", sizeof(CounterRates)},
+    {"Metrics", sizeof(MetricRegistry)},
+    {"Config", sizeof(Config)},
+    {"JSON arenas", sizeof(StaticMemory)},
+};
+static constexpr uint8_t regionCount = sizeof(regions) / sizeof(regions[0]);
+
+static constexpr size_t regionTotal(uint8_t i = 0) {
+    return i < regionCount ? regions[i].size + regionTotal(i + 1) : 0;
+}
+
+static_assert(regionTotal() <= STATIC_MEMORY_BUDGET, "static pools exceed STATIC_MEMORY_BUDGET");
+
+// Allocation hook state. Constant-initialized, so the hook may run before
+// any constructor, on any task.
+static std::atomic<bool> sealed(false);
+static std::atomic<uint32_t> heapCalls(0);
+static std::atomic<uint32_t> heapBytes(0);
+static std::atomic<uint32_t> heapLargest(0);
+static std::atomic<unsigned long> heapFirstAt(0);
+
+static void noteHeapCall(size_t size) {
+    if (!sealed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (heapCalls.fetch_add(1, std::memory_order_relaxed) == 0) {
+        heapFirstAt.store(millis(), std::memory_order_relaxed);
+    }
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    uint32_t largest = heapLargest.load(std::memory_order_relaxed);
+    while (size > largest && !heapLargest.compare_exchange_weak(largest, size, std::memory_order_relaxed)) {
+    }
+}
+
+#if STATIC_MEMORY
+#if CONFIG_HEAP_USE_HOOKS
+// Called by the heap on every successful allocation, malloc and String included
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    noteHeapCall(size);
+}
+#else
+// Without heap hooks only C++ allocations can be seen
+void* operator new(size_t size) {
+    noteHeapCall(size);
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+#endif
+
+void* JsonArena::allocate(size_t size) {
+    // Each block starts with its size, keeping 8-byte alignment
+    size_t block = 8 + ((size + 7) & ~(size_t)7);
+    if (block > JSON_ARENA_SIZE - used) {
+        return nullptr;
+    }
+    last = used;
+    *(size_t*)(buffer + last) = size;
+    used += block;
+    if (used > peak) {
+        peak = used;
+    }
+    return buffer + last + 8;
+}
+
+void JsonArena::deallocate(void* ptr) {
+    if (ptr && ptr == buffer + last + 8) {
+        used = last;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t size) {
+    if (!ptr) {
+        return allocate(size);
+    }
+
+    // The newest block is resized in place
+    if (ptr == buffer + last + 8) {
+        size_t block = 8 + ((size + 7) & ~(size_t)7);
+        if (block > JSON_ARENA_SIZE - last) {
+            return nullptr;
+        }
+        *(size_t*)(buffer + last) = size;
+        used = last + block;
+        if (used > peak) {
+            peak = used;
+        }
+        return ptr;
+    }
+
+    // Any other is copied; its space comes back with the next reset
+    size_t oldSize = *(size_t*)((uint8_t*)ptr - 8);
+    void* moved = allocate(size);
+    if (moved) {
+        memcpy(moved, ptr, oldSize < size ? oldSize : size);
+    }
+    return moved;
+}
+#endif
+
+StaticMemory::StaticMemory() : reportedCalls(0), reportedBlocks(0), lastReport(0), sealBlocks(0), sealBytes(0) {
+#if STATIC_MEMORY
+    for (uint8_t i = 0; i < JSON_ARENA_COUNT; i++) {
+        arenaBusy[i].store(false, std::memory_order_relaxed);
+    }
+    arenaMisses.store(0, std::memory_order_relaxed);
+    arenaOversize.store(0, std::memory_order_relaxed);
+    arenaOverflows.store(0, std::memory_order_relaxed);
+#endif
+}
+
+StaticMemory& StaticMemory::getInstance() {
+    static StaticMemory instance;
+    return instance;
+}
+
+void StaticMemory::seal() {
+#if STATIC_MEMORY
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+    sealBlocks = info.allocated_blocks;
+    sealBytes = info.total_allocated_bytes;
+#endif
+    sealed.store(true, std::memory_order_relaxed);
+    Serial.printf("Static memory: %u bytes in %u pools (budget %u, %u free)%s\r\n", (unsigned)regionTotal(),
+                  regionCount, (unsigned)STATIC_MEMORY_BUDGET, (unsigned)(STATIC_MEMORY_BUDGET - regionTotal()),
+                  STATIC_MEMORY ? ", counting heap calls" : "");
+}
+
+bool StaticMemory::isSealed() const {
+    return sealed.load(std::memory_order_relaxed);
+}
+
+void StaticMemory::update() {
+#if STATIC_MEMORY
+    // The block count walks the heap, so it is read at the report rate only
+    unsigned long now = millis();
+    if (!isSealed() || now - lastReport < HEAP_REPORT_INTERVAL) {
+        return;
+    }
+    lastReport = now;
+
+    // Network buffers come and go; only a new high in held blocks is news
+    HeapCallStats heap = getHeapCalls();
+    if (heap.calls == reportedCalls && heap.blocks <= reportedBlocks) {
+        return;
+    }
+    Serial.printf("Heap after setup: %lu calls (+%lu, %s), %ld blocks and %ld bytes held\r\n",
+                  (unsigned long)heap.calls, (unsigned long)(heap.calls - reportedCalls), HEAP_CALLS_COUNTED,
+                  (long)heap.blocks, (long)heap.heldBytes);
+    reportedCalls = heap.calls;
+    if (heap.blocks > reportedBlocks) {
+        reportedBlocks = heap.blocks;
+    }
+#endif
+}
+
+#if STATIC_MEMORY
+JsonArena* StaticMemory::acquireArena() {
+    for (uint8_t i = 0; i < JSON_ARENA_COUNT; i++) {
+        if (!arenaBusy[i].exchange(true, std::memory_order_acquire)) {
+            return &arenas[i];
+        }
+    }
+    arenaMisses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void StaticMemory::releaseArena(JsonArena* arena) {
+    arena->reset();
+    arenaBusy[arena - arenas].store(false, std::memory_order_release);
+}
+
+size_t StaticMemory::getArenaPeak() const {
+    size_t peak = 0;
+    for (uint8_t i = 0; i < JSON_ARENA_COUNT; i++) {
+        if (arenas[i].getPeak() > peak) {
+            peak = arenas[i].getPeak();
+        }
+    }
+    return peak;
+}
+#endif
+
+HeapCallStats StaticMemory::getHeapCalls() const {
+    HeapCallStats stats;
+    stats.calls = heapCalls.load(std::memory_order_relaxed);
+    stats.bytes = heapBytes.load(std::memory_order_relaxed);
+    stats.largest = heapLargest.load(std::memory_order_relaxed);
+    stats.firstAt = heapFirstAt.load(std::memory_order_relaxed);
+    stats.blocks = 0;
+    stats.heldBytes = 0;
+#if STATIC_MEMORY
+    if (isSealed()) {
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+        stats.blocks = (int32_t)(info.allocated_blocks - sealBlocks);
+        stats.heldBytes = (int32_t)(info.total_allocated_bytes - sealBytes);
+    }
+#endif
+    return stats;
+}
+
+const MemoryRegion* StaticMemory::getRegions() {
+    return regions;
+}
+
+uint8_t StaticMemory::getRegionCount() {
+    return regionCount;
+}
+
+size_t StaticMemory::getTotal() {
+    return regionTotal();
+}
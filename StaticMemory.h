@@ -0,0 +1,151 @@
+#ifndef STATIC_MEMORY_H
+#define STATIC_MEMORY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+
+// Build option. With 1, JSON frames are decoded into fixed arenas instead of
+// the heap, and every heap call made after setup() is counted by an
+// allocation hook (all of them with CONFIG_HEAP_USE_HOOKS in the core's
+// sdkconfig, C++ new otherwise). The heap's own block count is polled too,
+// which sees what any allocator still holds. The rest of the runtime paths
+// use fixed buffers in either build.
+#ifndef STATIC_MEMORY
+#define STATIC_MEMORY 0
+#endif
+
+#if CONFIG_HEAP_USE_HOOKS
+#define HEAP_CALLS_COUNTED "every allocator"
+#else
+#define HEAP_CALLS_COUNTED "C++ new only"
+#endif
+
+#define JSON_FRAME_MAX        2048          // Largest JSON frame decoded (as TCP_MAX_FRAME, BLE_MAX_MESSAGE)
+#define JSON_ARENA_SIZE       (JSON_FRAME_MAX * 3)  // Its strings, plus an 8-byte slot per ~4 bytes of text
+#define JSON_ARENA_COUNT      2             // Decodes that may run at once: the AsyncUDP task and loop()
+
+// ESP32 DRAM for .data/.bss is dram0_0_seg: 0x2C200 bytes less the 0xDB5C
+// the Bluetooth controller reserves. The core's own statics (Arduino, lwIP,
+// WiFi, Bluedroid; see the .map file) take part of it. What is left is heap,
+// shared with the regions above it that only the heap can use; the WiFi
+// and BLE stacks need more than those hold, so some of it stays free.
+#define DRAM_STATIC_SEGMENT   (0x2C200 - 0xDB5C)
+#define CORE_STATIC_SIZE      (36 * 1024)
+#define STACK_HEAP_RESERVE    (8 * 1024)
+#define STATIC_MEMORY_BUDGET  (DRAM_STATIC_SEGMENT - CORE_STATIC_SIZE - STACK_HEAP_RESERVE)  // Static pools (bytes)
+#define HEAP_REPORT_INTERVAL  10000         // Least time between heap call reports (ms)
+
+// One entry of the static memory map
+struct MemoryRegion {
+    const char* name;
+    size_t size;
+};
+
+// Heap calls seen by the allocation hook after setup()
+struct HeapCallStats {
+    uint32_t calls;
+    uint32_t bytes;
+    uint32_t largest;
+    unsigned long firstAt;   // millis() of the first one, 0 if none
+    int32_t blocks;          // Live heap blocks gained since setup(), any allocator
+    int32_t heldBytes;       // Bytes held by them
+};
+
+#if STATIC_MEMORY
+// Bump allocator behind one JsonDocument. Blocks are freed all at once when
+// the document is done; only the newest block can shrink, grow or be freed
+// before that, which is how a document builds its strings and pools.
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    JsonArena() : used(0), last(0), peak(0) {}
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t size) override;
+
+    void reset() { used = 0; last = 0; }
+    size_t getPeak() const { return peak; }
+
+private:
+    alignas(8) uint8_t buffer[JSON_ARENA_SIZE];
+    size_t used;
+    size_t last;     // Header of the newest block
+    size_t peak;
+};
+#endif
+
+class StaticMemory {
+public:
+    static StaticMemory& getInstance();
+
+    // End of setup(): heap calls from here on are counted
+    void seal();
+    bool isSealed() const;
+
+    // Logs new heap calls since the last report (from loop())
+    void update();
+
+#if STATIC_MEMORY
+    // A free arena for one decode; nullptr (counted) if every one is in use.
+    // Safe from any task.
+    JsonArena* acquireArena();
+    void releaseArena(JsonArena* arena);
+    size_t getArenaPeak() const;
+    uint32_t getArenaMisses() const { return arenaMisses.load(std::memory_order_relaxed); }
+
+    // Frames dropped for not fitting: longer than JSON_FRAME_MAX, or a
+    // document that outgrew its arena
+    void noteOversize() { arenaOversize.fetch_add(1, std::memory_order_relaxed); }
+    void noteOverflow() { arenaOverflows.fetch_add(1, std::memory_order_relaxed); }
+    uint32_t getArenaOversize() const { return arenaOversize.load(std::memory_order_relaxed); }
+    uint32_t getArenaOverflows() const { return arenaOverflows.load(std::memory_order_relaxed); }
+#endif
+
+    HeapCallStats getHeapCalls() const;
+
+    // Memory map: the fixed pools of this build, sized at compile time
+    static const MemoryRegion* getRegions();
+    static uint8_t getRegionCount();
+    static size_t getTotal();
+
+private:
+    StaticMemory();
+
+#if STATIC_MEMORY
+    JsonArena arenas[JSON_ARENA_COUNT];
+    std::atomic<bool> arenaBusy[JSON_ARENA_COUNT];
+    std::atomic<uint32_t> arenaMisses;
+    std::atomic<uint32_t> arenaOversize;
+    std::atomic<uint32_t> arenaOverflows;
+#endif
+    uint32_t reportedCalls;
+    int32_t reportedBlocks;  // Highest held block count logged
+    unsigned long lastReport;
+    size_t sealBlocks;       // Heap state when setup() ended
+    size_t sealBytes;
+};
+
+#if STATIC_MEMORY
+// Holds an arena for the scope of one decode; declare it before the
+// JsonDocument so the document is gone when the arena is returned
+class JsonArenaLease {
+public:
+    JsonArenaLease() : arena(StaticMemory::getInstance().acquireArena()) {}
+    ~JsonArenaLease() {
+        if (arena) {
+            StaticMemory::getInstance().releaseArena(arena);
+        }
+    }
+
+    JsonArena* get() const { return arena; }
+    explicit operator bool() const { return arena != nullptr; }
+
+private:
+    JsonArena* arena;
+    JsonArenaLease(const JsonArenaLease&) = delete;
+    JsonArenaLease& operator=(const JsonArenaLease&) = delete;
+};
+#endif
+
+#endif
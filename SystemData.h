@@ -3,6 +3,131 @@
 
 #include <Arduino.h>
 
+// Field presence bits, one per SystemData field. Delta frames carry only
+// the fields that changed; the mask tells the receiver which ones to merge.
+enum SystemDataField : uint32_t {
+    FIELD_CPU_USAGE        = 1UL << 0,
+    FIELD_CPU_TEMP         = 1UL << 1,
+    FIELD_CPU_NAME         = 1UL << 2,
+    FIELD_MEMORY_USED      = 1UL << 3,
+    FIELD_MEMORY_TOTAL     = 1UL << 4,
+    FIELD_MEMORY_PERCENT   = 1UL << 5,
+    FIELD_DISK_USED        = 1UL << 6,
+    FIELD_DISK_TOTAL       = 1UL << 7,
+    FIELD_DISK_PERCENT     = 1UL << 8,
+    FIELD_NETWORK_UPLOAD   = 1UL << 9,
+    FIELD_NETWORK_DOWNLOAD = 1UL << 10,
+    FIELD_GPU_USAGE        = 1UL << 11,
+    FIELD_GPU_TEMP         = 1UL << 12,
+    FIELD_MOTHERBOARD_TEMP = 1UL << 13,
+    FIELD_DISK_TEMP        = 1UL << 14,
+    FIELD_DISK_NAME        = 1UL << 15,
+    FIELD_DISK_READ        = 1UL << 16,
+    FIELD_DISK_WRITE       = 1UL << 17,
+
+    FIELD_ALL              = (1UL << 18) - 1
+};
+
+// Field groups. Each group changes at its own pace, so a sender may refresh
+// it at its own rate (load at 10 Hz, capacities every few seconds); the
+// receiver tracks the age of each group separately.
+enum SystemDataGroup : uint8_t {
+    GROUP_LOAD = 0,      // CPU/GPU usage, memory in use, network and disk I/O rates
+    GROUP_THERMAL,       // Temperatures
+    GROUP_CAPACITY,      // Memory total, disk usage
+    GROUP_INFO,          // CPU and disk names
+    GROUP_COUNT
+};
+
+#define GROUP_BIT(group) (1 << (group))
+#define GROUP_MASK_ALL   ((1 << GROUP_COUNT) - 1)
+
+#define GROUP_LOAD_FIELDS     (FIELD_CPU_USAGE | FIELD_MEMORY_USED | FIELD_MEMORY_PERCENT | \
+                               FIELD_NETWORK_UPLOAD | FIELD_NETWORK_DOWNLOAD | FIELD_GPU_USAGE | \
+                               FIELD_DISK_READ | FIELD_DISK_WRITE)
+#define GROUP_THERMAL_FIELDS  (FIELD_CPU_TEMP | FIELD_GPU_TEMP | FIELD_MOTHERBOARD_TEMP | FIELD_DISK_TEMP)
+#define GROUP_CAPACITY_FIELDS (FIELD_MEMORY_TOTAL | FIELD_DISK_USED | FIELD_DISK_TOTAL | FIELD_DISK_PERCENT)
+#define GROUP_INFO_FIELDS     (FIELD_CPU_NAME | FIELD_DISK_NAME)
+
+// JSON object each field sits in. A nested section is the first entry of an
+// array inside its parent: SECTION_DISKS is "temperatures": {"disks": [{...}]}.
+enum SystemDataSection : uint8_t {
+    SECTION_CPU = 0,
+    SECTION_MEMORY,
+    SECTION_DISK,
+    SECTION_NETWORK,
+    SECTION_GPU,
+    SECTION_TEMPERATURES,
+    SECTION_DISKS,
+    SECTION_COUNT
+};
+
+// Every SystemData field in FIELD_* bit order, which is also the binary
+// wire order. JSON and binary parsing, merge, /status, the web home page and
+// the metric registry all expand this one list:
+//   NUMBER(bit, member, section, JSON key, metric name, unit, label)
+//   TEXT(bit, member, section, JSON key, label)
+#define SYSTEM_DATA_FIELDS(NUMBER, TEXT) \
+    NUMBER(FIELD_CPU_USAGE,        cpuUsage,        SECTION_CPU,          "usage",       "cpu.usage",        "%",    "CPU Usage") \
+    NUMBER(FIELD_CPU_TEMP,         cpuTemp,         SECTION_CPU,          "temp",        "cpu.temp",         "C",    "CPU Temp") \
+    TEXT(FIELD_CPU_NAME,           cpuName,         SECTION_CPU,          "name",                                    "CPU") \
+    NUMBER(FIELD_MEMORY_USED,      memoryUsed,      SECTION_MEMORY,       "used",        "memory.used",      "GB",   "Memory Used") \
+    NUMBER(FIELD_MEMORY_TOTAL,     memoryTotal,     SECTION_MEMORY,       "total",       "memory.total",     "GB",   "Memory Total") \
+    NUMBER(FIELD_MEMORY_PERCENT,   memoryPercent,   SECTION_MEMORY,       "percent",     "memory.percent",   "%",    "Memory") \
+    NUMBER(FIELD_DISK_USED,        diskUsed,        SECTION_DISK,         "used",        "disk.used",        "GB",   "Disk Used") \
+    NUMBER(FIELD_DISK_TOTAL,       diskTotal,       SECTION_DISK,         "total",       "disk.total",       "GB",   "Disk Total") \
+    NUMBER(FIELD_DISK_PERCENT,     diskPercent,     SECTION_DISK,         "percent",     "disk.percent",     "%",    "Disk") \
+    NUMBER(FIELD_NETWORK_UPLOAD,   networkUpload,   SECTION_NETWORK,      "upload",      "network.upload",   "KB/s", "Network Upload") \
+    NUMBER(FIELD_NETWORK_DOWNLOAD, networkDownload, SECTION_NETWORK,      "download",    "network.download", "KB/s", "Network Download") \
+    NUMBER(FIELD_GPU_USAGE,        gpuUsage,        SECTION_GPU,          "usage",       "gpu.usage",        "%",    "GPU Usage") \
+    NUMBER(FIELD_GPU_TEMP,         gpuTemp,         SECTION_GPU,          "temp",        "gpu.temp",         "C",    "GPU Temp") \
+    NUMBER(FIELD_MOTHERBOARD_TEMP, motherboardTemp, SECTION_TEMPERATURES, "motherboard", "board.temp",       "C",    "Motherboard Temp") \
+    NUMBER(FIELD_DISK_TEMP,        diskTemp,        SECTION_DISKS,        "temp",        "disk.temp",        "C",    "Disk Temp") \
+    TEXT(FIELD_DISK_NAME,          diskName,        SECTION_DISKS,        "name",                                    "Disk Name") \
+    NUMBER(FIELD_DISK_READ,        diskRead,        SECTION_DISK,         "read",        "disk.read",        "KB/s", "Disk Read") \
+    NUMBER(FIELD_DISK_WRITE,       diskWrite,       SECTION_DISK,         "write",       "disk.write",       "KB/s", "Disk Write")
+
+// Age after which a group is shown as stale (ms); 0 never goes stale
+#define GROUP_LOAD_STALE      3000
+#define GROUP_THERMAL_STALE   5000
+#define GROUP_CAPACITY_STALE  30000
+#define GROUP_INFO_STALE      0
+
+inline uint32_t groupFields(uint8_t group) {
+    switch (group) {
+        case GROUP_LOAD: return GROUP_LOAD_FIELDS;
+        case GROUP_THERMAL: return GROUP_THERMAL_FIELDS;
+        case GROUP_CAPACITY: return GROUP_CAPACITY_FIELDS;
+        case GROUP_INFO: return GROUP_INFO_FIELDS;
+        default: return 0;
+    }
+}
+
+inline uint32_t groupStaleAfter(uint8_t group) {
+    switch (group) {
+        case GROUP_LOAD: return GROUP_LOAD_STALE;
+        case GROUP_THERMAL: return GROUP_THERMAL_STALE;
+        case GROUP_CAPACITY: return GROUP_CAPACITY_STALE;
+        default: return GROUP_INFO_STALE;
+    }
+}
+
+// True if a group last refreshed at updated (0: never) is stale at now
+inline bool groupIsStale(uint8_t group, unsigned long updated, unsigned long now) {
+    uint32_t limit = groupStaleAfter(group);
+    return limit > 0 && (updated == 0 || now - updated > limit);
+}
+
+inline const char* groupName(uint8_t group) {
+    switch (group) {
+        case GROUP_LOAD: return "load";
+        case GROUP_THERMAL: return "thermal";
+        case GROUP_CAPACITY: return "capacity";
+        case GROUP_INFO: return "info";
+        default: return "?";
+    }
+}
+
 // System data structure received from PC
 struct SystemData {
     // CPU info
@@ -19,6 +144,8 @@ struct SystemData {
     float diskUsed;
     float diskTotal;
     float diskPercent;
+    float diskRead;   // KB/s
+    float diskWrite;
 
     // Network info
     float networkUpload;
@@ -36,25 +163,57 @@ struct SystemData {
     // Timestamp
     unsigned long timestamp;
 
+    // Per-group refresh times (local millis(), 0 until first received) and
+    // the groups changed since the display last drew them
+    unsigned long groupUpdated[GROUP_COUNT];
+    uint8_t dirtyGroups;
+
     SystemData() {
-        cpuUsage = 0;
-        cpuTemp = 0;
-        memset(cpuName, 0, sizeof(cpuName));
-        memoryUsed = 0;
-        memoryTotal = 0;
-        memoryPercent = 0;
-        diskUsed = 0;
-        diskTotal = 0;
-        diskPercent = 0;
-        networkUpload = 0;
-        networkDownload = 0;
-        gpuUsage = 0;
-        gpuTemp = 0;
-        motherboardTemp = 0;
-        diskTemp = 0;
-        memset(diskName, 0, sizeof(diskName));
+#define RESET_NUMBER(bit, member, ...) member = 0;
+#define RESET_TEXT(bit, member, ...) memset(member, 0, sizeof(member));
+        SYSTEM_DATA_FIELDS(RESET_NUMBER, RESET_TEXT)
+#undef RESET_NUMBER
+#undef RESET_TEXT
         timestamp = 0;
+        memset(groupUpdated, 0, sizeof(groupUpdated));
+        dirtyGroups = 0;
     }
+
+    // Copy the fields selected by mask from src (delta merge)
+    void merge(const SystemData& src, uint32_t mask) {
+#define MERGE_NUMBER(bit, member, ...) if (mask & bit) member = src.member;
+#define MERGE_TEXT(bit, member, ...) if (mask & bit) memcpy(member, src.member, sizeof(member));
+        SYSTEM_DATA_FIELDS(MERGE_NUMBER, MERGE_TEXT)
+#undef MERGE_NUMBER
+#undef MERGE_TEXT
+        timestamp = src.timestamp;
+    }
+
+    // Record a frame: groups with a field in fresh are current as of now,
+    // groups with a field in changed need redrawing
+    void touch(uint32_t fresh, uint32_t changed, unsigned long now) {
+        for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+            if (fresh & groupFields(group)) {
+                groupUpdated[group] = now;
+            }
+            if (changed & groupFields(group)) {
+                dirtyGroups |= 1 << group;
+            }
+        }
+    }
+
+    // Bit per group not refreshed within its stale age
+    uint8_t staleGroups(unsigned long now) const {
+        uint8_t stale = 0;
+        for (uint8_t group = 0; group < GROUP_COUNT; group++) {
+            if (groupIsStale(group, groupUpdated[group], now)) {
+                stale |= 1 << group;
+            }
+        }
+        return stale;
+    }
+
+    void clearDirty() { dirtyGroups = 0; }
 };
 
 #endif
@@ -0,0 +1,219 @@
+#include "TcpComm.h"
+#include "Config.h"
+
+TcpComm::TcpComm() : CommInterface(COMM_TCP), localPort(0),
+                     rxLength(0), lastReceiveTime(0) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+TcpComm::~TcpComm() {
+    stop();
+}
+
+bool TcpComm::begin() {
+    Config& cfg = Config::getInstance();
+
+    if (cfg.getWiFiSSID().length() == 0) {
+        Serial.println("TCP needs WiFi, but no SSID is configured");
+        return false;
+    }
+
+    // The server starts once the WiFi link has an address
+    localPort = cfg.getServerPort();
+    return true;
+}
+
+void TcpComm::update() {
+    bool wifiUp = WiFi.status() == WL_CONNECTED;
+
+    if (wifiUp && !stats.listening) {
+        server.begin(localPort);
+        server.setNoDelay(true);
+        stats.listening = true;
+        Serial.printf("TCP server listening on port %d\r\n", localPort);
+    } else if (!wifiUp && stats.listening) {
+        dropClient("WiFi down");
+        server.end();
+        stats.listening = false;
+        return;
+    }
+
+    if (!stats.listening) {
+        return;
+    }
+
+    acceptClient();
+
+    if (stats.clientConnected) {
+        if (client.connected() || client.available() > 0) {
+            readStream();
+        } else {
+            dropClient("closed by peer");
+        }
+    }
+}
+
+void TcpComm::acceptClient() {
+    if (!server.hasClient()) {
+        return;
+    }
+
+    // One persistent sender; a new connection usually means the old one died
+    WiFiClient incoming = server.accept();
+    if (stats.clientConnected) {
+        stats.replaced++;
+        dropClient("replaced by new connection");
+    }
+
+    client = incoming;
+    clientAddress = client.remoteIP();
+    client.setNoDelay(true);
+    stats.clientConnected = true;
+    rxLength = 0;
+    stats.accepts++;
+    stats.connectedSince = millis();
+    Serial.printf("TCP client connected: %s\r\n", clientAddress.toString().c_str());
+    notifyLink(true);
+}
+
+void TcpComm::readStream() {
+    size_t budget = TCP_READ_BUDGET;
+
+    // Frames held back while the queue was full
+    if (rxLength > 0 && !parseFrames()) {
+        dropClient("protocol error");
+        return;
+    }
+
+    while (budget > 0) {
+        // Backpressure: while the frame queue is full, leave bytes in the
+        // socket so the TCP window closes and the sender slows down
+        if (rxRing.size() >= rxRing.capacity()) {
+            stats.stalls++;
+            return;
+        }
+
+        int available = client.available();
+        size_t space = sizeof(rxBuffer) - rxLength;
+        if (available <= 0 || space == 0) {
+            return;
+        }
+
+        size_t want = (size_t)available < space ? (size_t)available : space;
+        if (want > budget) {
+            want = budget;
+        }
+
+        int n = client.read(rxBuffer + rxLength, want);
+        if (n <= 0) {
+            return;
+        }
+        rxLength += n;
+        budget -= n;
+        if (rxLength > stats.peakBuffered) {
+            stats.peakBuffered = rxLength;
+        }
+
+        if (!parseFrames()) {
+            dropClient("protocol error");
+            return;
+        }
+    }
+}
+
+bool TcpComm::parseFrames() {
+    size_t offset = 0;
+
+    while (rxLength - offset >= TCP_LENGTH_PREFIX) {
+        size_t length = ((size_t)rxBuffer[offset] << 8) | rxBuffer[offset + 1];
+        if (length == 0 || length > TCP_MAX_FRAME) {
+            // The stream is out of sync; there is no way to find the next frame
+            stats.protocolErrors++;
+            return false;
+        }
+        if (rxLength - offset < TCP_LENGTH_PREFIX + length) {
+            break;  // Incomplete frame
+        }
+        if (rxRing.size() >= rxRing.capacity()) {
+            break;  // Keep it buffered until loop() catches up
+        }
+
+        TelemetryFrame* frame = rxRing.acquire();
+        *frame = TelemetryFrame();
+        if (decodePayload(rxBuffer + offset + TCP_LENGTH_PREFIX, length, *frame)) {
+            setSourceAddress(*frame, clientAddress);
+            rxRing.commit();
+        } else {
+            stats.decodeErrors++;
+        }
+        offset += TCP_LENGTH_PREFIX + length;
+    }
+
+    if (offset > 0) {
+        memmove(rxBuffer, rxBuffer + offset, rxLength - offset);
+        rxLength -= offset;
+    }
+    return true;
+}
+
+void TcpComm::dropClient(const char* reason) {
+    if (!stats.clientConnected) {
+        return;
+    }
+
+    Serial.printf("TCP client disconnected (%s)\r\n", reason);
+    client.stop();
+    stats.clientConnected = false;
+    rxLength = 0;
+    stats.disconnects++;
+    notifyLink(false);
+}
+
+void TcpComm::sendFeedback(const uint8_t* message, size_t length) {
+    if (!stats.clientConnected) {
+        return;
+    }
+
+    uint8_t frame[TCP_LENGTH_PREFIX + FEEDBACK_SIZE];
+    if (length > FEEDBACK_SIZE) {
+        return;
+    }
+    frame[0] = length >> 8;
+    frame[1] = length & 0xFF;
+    memcpy(frame + TCP_LENGTH_PREFIX, message, length);
+    if (client.write(frame, TCP_LENGTH_PREFIX + length) == TCP_LENGTH_PREFIX + length) {
+        stats.feedbackSent++;
+    }
+}
+
+bool TcpComm::isConnected() {
+    return stats.clientConnected;
+}
+
+bool TcpComm::receiveData(SystemData& data) {
+    // Apply every queued frame in order; only the newest state leaves this call
+    uint32_t received = 0;
+    noteQueueDepth(rxRing.size(), rxRing.capacity());
+    while (TelemetryFrame* frame = rxRing.peek()) {
+        if (applyFrame(*frame, data)) {
+            received++;
+        }
+        rxRing.release();
+    }
+
+    if (received == 0) {
+        return false;
+    }
+
+    lastReceiveTime = millis();
+    countCoalesced(received - 1);
+    return true;
+}
+
+void TcpComm::stop() {
+    dropClient("stopped");
+    if (stats.listening) {
+        server.end();
+        stats.listening = false;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef TCP_COMM_H
+#define TCP_COMM_H
+
+#include "CommInterface.h"
+#include <WiFi.h>
+#include "SpscRing.h"
+
+// Stream framing: [length u16, big-endian][payload], payload JSON or binary.
+// Feedback to the sender uses the same framing.
+#define TCP_LENGTH_PREFIX 2
+#define TCP_MAX_FRAME     2048   // Larger length prefixes are a protocol error
+#define TCP_RX_BUFFER     4096   // Stream bytes awaiting a complete frame
+#define TCP_RX_RING_SIZE  4      // Decoded frames awaiting loop()
+#define TCP_READ_BUDGET   2048   // Bytes read per update() so loop() stays responsive
+
+struct TcpLinkStats {
+    bool listening;
+    bool clientConnected;
+    uint32_t accepts;
+    uint32_t disconnects;
+    uint32_t replaced;        // Connections dropped for a newer client
+    uint32_t stalls;          // Reads deferred because the frame queue was full
+    uint32_t protocolErrors;  // Bad length prefixes (connection dropped)
+    uint32_t decodeErrors;    // Well-framed payloads that failed to decode
+    uint32_t peakBuffered;    // Most stream bytes held at once
+    uint32_t feedbackSent;
+    unsigned long connectedSince;
+};
+
+// Persistent TCP stream on getServerPort(); rides on the WiFi link
+class TcpComm : public CommInterface {
+public:
+    TcpComm();
+    ~TcpComm();
+
+    bool begin() override;
+    void update() override;
+    bool isConnected() override;
+    bool receiveData(SystemData& data) override;
+    void stop() override;
+
+    const TcpLinkStats& getStats() const { return stats; }
+
+private:
+    WiFiServer server;
+    WiFiClient client;
+    IPAddress clientAddress;   // Source of frames without a host ID
+    uint16_t localPort;
+    uint8_t rxBuffer[TCP_RX_BUFFER];
+    size_t rxLength;
+    SpscRing<TelemetryFrame, TCP_RX_RING_SIZE> rxRing;
+    unsigned long lastReceiveTime;
+    TcpLinkStats stats;
+
+    void acceptClient();
+    void readStream();
+    bool parseFrames();
+    void dropClient(const char* reason);
+    void sendFeedback(const uint8_t* message, size_t length) override;
+};
+
+#endif
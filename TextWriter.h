@@ -0,0 +1,62 @@
+#ifndef TEXT_WRITER_H
+#define TEXT_WRITER_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Bounded printing into a caller's buffer; output past the end is dropped.
+// Used wherever text is built at runtime, so no String or heap is involved.
+struct TextWriter {
+    char* out;
+    size_t size;
+    size_t length;
+
+    TextWriter(char* out, size_t size) : out(out), size(size), length(0) {
+        if (size > 0) {
+            out[0] = '\0';
+        }
+    }
+
+    void printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (length + 1 >= size) {
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(out + length, size - length, format, args);
+        va_end(args);
+        if (n > 0) {
+            length += (size_t)n < size - length ? n : size - length - 1;
+        }
+    }
+
+    // Copies a string as is
+    void print(const char* str) {
+        for (; *str && length + 1 < size; str++) {
+            out[length++] = *str;
+        }
+        if (length < size) {
+            out[length] = '\0';
+        }
+    }
+
+    // Copies text escaped for a JSON string or for HTML; drops control characters
+    void text(const char* str, bool html) {
+        for (; *str && length + 1 < size; str++) {
+            char c = *str;
+            if (html && (c == '<' || c == '>' || c == '&' || c == '\'')) {
+                print(c == '<' ? "&lt;" : (c == '>' ? "&gt;" : (c == '&' ? "&amp;" : "&#39;")));
+            } else if (!html && (c == '"' || c == '\\')) {
+                printf("\\%c", c);
+            } else if ((uint8_t)c >= 0x20) {
+                out[length++] = c;
+                out[length] = '\0';
+            }
+        }
+    }
+
+    // True once output had to be dropped
+    bool isFull() const { return length + 1 >= size; }
+};
+
+#endif
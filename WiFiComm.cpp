@@ -2,8 +2,17 @@
 #include "Config.h"
 #include <ArduinoJson.h>
 
-WiFiComm::WiFiComm() : connected(false), lastReceiveTime(0) {
+WiFiComm::WiFiComm() : CommInterface(COMM_WIFI), connected(false), lastReceiveTime(0), stateSince(0), eventId(0),
+                       eventRegistered(false), gotIPPending(false), disconnectPending(false),
+                       disconnectExpected(false), disconnectReason(0), fastAttempt(false), skipFast(false) {
     localPort = Config::getInstance().getServerPort();
+    memset(&stats, 0, sizeof(stats));
+    memset(peers, 0, sizeof(peers));
+    for (int i = 0; i < WIFI_REASSEMBLY_SLOTS; i++) {
+        reassembly[i].active = false;
+    }
+    stats.state = WIFI_STATE_OFF;
+    stats.backoffMs = WIFI_BACKOFF_MIN;
 }
 
 WiFiComm::~WiFiComm() {
@@ -12,8 +21,7 @@ WiFiComm::~WiFiComm() {
 
 bool WiFiComm::begin() {
     Config& cfg = Config::getInstance();
-    String ssid = cfg.getWiFiSSID();
-    String password = cfg.getWiFiPassword();
+    const String& ssid = cfg.getWiFiSSID();
 
     if (ssid.length() == 0) {
         Serial.println("WiFi SSID not configured\r\n");
@@ -23,88 +31,507 @@ bool WiFiComm::begin() {
         return false;
     }
 
-    connectToWiFi();
+    // The supervisor handles reconnects itself, with backoff
+    if (!eventRegistered) {
+        eventId = WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t info) { onWiFiEvent(event, info); });
+        eventRegistered = true;
+    }
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);
 
-    if (WiFi.status() == WL_CONNECTED) {
-        udp.begin(localPort);
-        Serial.printf("WiFi connected. IP: %s, Port: %d\r\n",
-                     WiFi.localIP().toString().c_str(), localPort);
+    stats.backoffMs = WIFI_BACKOFF_MIN;
+    startConnect();
+    return true;
+}
 
-        // Initialize mDNS
-        String mdnsName = cfg.getMDNSName();
-        if (MDNS.begin(mdnsName.c_str())) {
-            Serial.printf("mDNS responder started: %s.local\r\n", mdnsName.c_str());
+void WiFiComm::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    // Runs on the WiFi event task: only raise flags for update()
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            disconnectExpected = false;  // Events are in order: it never came
+            gotIPPending = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            if (disconnectExpected.exchange(false)) {
+                break;  // Raised by the fallback's own WiFi.disconnect()
+            }
+            disconnectReason = info.wifi_sta_disconnected.reason;
+            disconnectPending = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            disconnectPending = true;
+            break;
+        default:
+            break;
+    }
+}
 
-            // Add service to mDNS-SD
-            MDNS.addService("esp32monitor", "udp", localPort);
-            Serial.printf("mDNS service advertised: _esp32monitor._udp.local port %d\r\n", localPort);
-        } else {
-            Serial.println("Error starting mDNS responder\r\n");
-        }
+void WiFiComm::setState(WiFiLinkState state) {
+    stats.state = state;
+    stateSince = millis();
+}
+
+void WiFiComm::startConnect() {
+    Config& cfg = Config::getInstance();
+    const String& ssid = cfg.getWiFiSSID();
+    const String& password = cfg.getWiFiPassword();
+    WiFiCache cache = cfg.getWiFiCache();
+    StaticIPConfig ipConfig = cfg.getStaticIP();
+
+    fastAttempt = cache.valid && !skipFast;
 
-        connected = true;
-        return true;
+    // Static IP, then the cached lease (directed attempts only), then DHCP
+    if (ipConfig.ip != 0) {
+        WiFi.config(IPAddress(ipConfig.ip), IPAddress(ipConfig.gateway),
+                    IPAddress(ipConfig.subnet), IPAddress(ipConfig.dns));
+    } else if (fastAttempt && cfg.getWiFiFastLease() && cache.ip != 0) {
+        WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+                    IPAddress(cache.subnet), IPAddress(cache.dns));
+    } else {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
     }
 
-    // Connection failed - clean up WiFi
-    Serial.println("WiFi connection failed\r\n");
-    WiFi.disconnect(true);
-    return false;
+    gotIPPending = false;
+    disconnectPending = false;
+    if (fastAttempt) {
+        // Skip the scan: go straight to the last AP on its channel
+        Serial.printf("Connecting to WiFi: %s (cached AP, channel %d)\r\n", ssid.c_str(), cache.channel);
+        WiFi.begin(ssid.c_str(), password.c_str(), cache.channel, cache.bssid);
+    } else {
+        Serial.printf("Connecting to WiFi: %s\r\n", ssid.c_str());
+        WiFi.begin(ssid.c_str(), password.c_str());
+    }
+    stats.attempts++;
+    setState(WIFI_STATE_CONNECTING);
+}
+
+void WiFiComm::connectFailed(const char* reason) {
+    Serial.printf("WiFi connection %s (reason %d)\r\n", reason, stats.lastReason);
+
+    if (fastAttempt) {
+        // The AP may have moved channel or been replaced: rescan right away
+        stats.fastFailures++;
+        skipFast = true;
+        // The event for this disconnect arrives after startConnect(): mark
+        // it so it isn't taken as the scan attempt failing
+        disconnectExpected = true;
+        WiFi.disconnect();
+        startConnect();
+        return;
+    }
+    startBackoff();
+}
+
+void WiFiComm::startBackoff() {
+    disconnectExpected = false;
+    WiFi.disconnect();
+    disconnectPending = false;  // Our own disconnect is not a new event
+    Serial.printf("WiFi retry in %lu ms\r\n", (unsigned long)stats.backoffMs);
+    setState(WIFI_STATE_BACKOFF);
+}
+
+void WiFiComm::update() {
+    // Never blocks: events are flagged by the WiFi task and handled here
+    unsigned long now = millis();
+
+    if (gotIPPending.exchange(false) && stats.state == WIFI_STATE_CONNECTING) {
+        setState(WIFI_STATE_CONNECTED);
+        onLinkUp();
+    }
+
+    if (disconnectPending.exchange(false)) {
+        stats.lastReason = disconnectReason;
+        if (stats.state == WIFI_STATE_CONNECTED) {
+            stats.disconnects++;
+            Serial.printf("WiFi disconnected (reason %d)\r\n", stats.lastReason);
+            onLinkDown();
+            stats.backoffMs = WIFI_BACKOFF_MIN;
+            startBackoff();
+        } else if (stats.state == WIFI_STATE_CONNECTING) {
+            connectFailed("failed");
+        }
+    }
+
+    switch (stats.state) {
+        case WIFI_STATE_CONNECTING:
+            if (now - stateSince >= (fastAttempt ? WIFI_FAST_TIMEOUT : WIFI_CONNECT_TIMEOUT)) {
+                connectFailed("timed out");
+            }
+            break;
+        case WIFI_STATE_BACKOFF:
+            if (now - stateSince >= stats.backoffMs) {
+                stats.backoffMs = stats.backoffMs * 2 > WIFI_BACKOFF_MAX ? WIFI_BACKOFF_MAX : stats.backoffMs * 2;
+                startConnect();
+            }
+            break;
+        default:
+            break;
+    }
 }
 
-void WiFiComm::connectToWiFi() {
+void WiFiComm::onLinkUp() {
     Config& cfg = Config::getInstance();
-    String ssid = cfg.getWiFiSSID();
-    String password = cfg.getWiFiPassword();
+    unsigned long now = millis();
 
-    Serial.printf("Connecting to WiFi: %s\r\n", ssid.c_str());
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid.c_str(), password.c_str());
+    stats.connects++;
+    stats.connectedSince = now;
+    stats.backoffMs = WIFI_BACKOFF_MIN;
+    stats.lastConnectFast = fastAttempt;
+    stats.lastConnectMs = now - stateSince;
+    if (stats.bootConnectMs == 0) {
+        stats.bootConnectMs = now;
+    }
+    if (fastAttempt) {
+        stats.fastConnects++;
+    }
+    skipFast = false;
+    saveAssociation();
+
+    startListening();
+    Serial.printf("WiFi connected in %lu ms%s. IP: %s, Port: %d\r\n",
+                 stats.lastConnectMs, fastAttempt ? " (cached AP)" : "",
+                 WiFi.localIP().toString().c_str(), localPort);
 
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
+    // Initialize mDNS
+    const String& mdnsName = cfg.getMDNSName();
+    if (MDNS.begin(mdnsName.c_str())) {
+        Serial.printf("mDNS responder started: %s.local\r\n", mdnsName.c_str());
+
+        // Add service to mDNS-SD; senders read the group from the TXT record
+        MDNS.addService("esp32monitor", "udp", localPort);
+        Serial.printf("mDNS service advertised: _esp32monitor._udp.local port %d\r\n", localPort);
+        if (stats.multicastGroup != 0) {
+            MDNS.addServiceTxt("esp32monitor", "udp", "group", IPAddress(stats.multicastGroup).toString().c_str());
+        }
+    } else {
+        Serial.println("Error starting mDNS responder\r\n");
     }
-    Serial.println("\r\n");
+
+    connected = true;
+    notifyLink(true);
 }
 
-void WiFiComm::update() {
-    if (WiFi.status() != WL_CONNECTED) {
-        if (connected) {
-            Serial.println("WiFi disconnected\r\n");
-            connected = false;
+void WiFiComm::startListening() {
+    IPAddress group(Config::getInstance().getMulticastGroup());
+    bool joined = false;
+
+    // The socket is closed, so no callback touches the pool while it resets
+    for (int i = 0; i < WIFI_REASSEMBLY_SLOTS; i++) {
+        reassembly[i].active = false;
+    }
+
+    // Datagrams are decoded straight from the lwIP pbuf on the AsyncUDP
+    // task and handed to loop() through rxRing. A multicast socket is bound
+    // to any address, so it takes unicast frames on the same port too.
+    if (isMulticastAddress(group)) {
+        joined = udp.listenMulticast(group, localPort);
+        if (joined) {
+            Serial.printf("Joined multicast group %s\r\n", group.toString().c_str());
+        } else {
+            Serial.println("Multicast join failed, listening for unicast only");
         }
-        return;
     }
 
-    if (!connected) {
-        connected = true;
-        Serial.println("WiFi reconnected\r\n");
+    if (joined || udp.listen(localPort)) {
+        udp.onPacket([this](AsyncUDPPacket& packet) { handlePacket(packet); });
+    } else {
+        Serial.println("UDP listen failed\r\n");
     }
+    stats.multicastGroup = joined ? (uint32_t)group : 0;
+}
+
+void WiFiComm::saveAssociation() {
+    Config& cfg = Config::getInstance();
+    WiFiCache cache = cfg.getWiFiCache();
+
+    cache.valid = true;
+    memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+    cache.channel = WiFi.channel();
+
+    // Keep the lease only when it came from DHCP
+    if (cfg.getStaticIP().ip == 0) {
+        cache.ip = (uint32_t)WiFi.localIP();
+        cache.gateway = (uint32_t)WiFi.gatewayIP();
+        cache.subnet = (uint32_t)WiFi.subnetMask();
+        cache.dns = (uint32_t)WiFi.dnsIP();
+    }
+    cfg.setWiFiCache(cache);
+}
+
+void WiFiComm::onLinkDown() {
+    connected = false;
+    MDNS.end();
+    udp.close();
+    notifyLink(false);
 }
 
 bool WiFiComm::isConnected() {
     return connected && (WiFi.status() == WL_CONNECTED);
 }
 
+void WiFiComm::handlePacket(AsyncUDPPacket& packet) {
+    // Runs on the AsyncUDP task: decode in place and touch nothing loop()
+    // writes; the frame counters below are only written here
+    const uint8_t* payload = packet.data();
+    size_t length = packet.length();
+    uint32_t address = (uint32_t)packet.remoteIP();
+
+    WiFiReassembly* message = nullptr;
+    if (length > 0 && payload[0] == WIFI_FRAG_MAGIC) {
+        message = handleFragment(payload, length, address, packet.remotePort());
+        if (!message) {
+            return;  // Waiting for more fragments
+        }
+        payload = message->data;
+        length = message->length;
+    }
+
+    // A full ring still takes the newest frame: it is decoded aside and
+    // folded into the newest queued one, so loop() never runs behind
+    bool full = rxRing.isFull();
+    TelemetryFrame* frame = full ? &overflowFrame : rxRing.acquire();
+    if (frame) {
+        *frame = TelemetryFrame();
+        if (decodePayload(payload, length, *frame)) {
+            setSourceAddress(*frame, packet.remoteIP());
+            frame->senderAddress = address;
+            frame->senderPort = packet.remotePort();
+            if (full) {
+                coalesceNewest();
+            } else {
+                rxRing.commit();
+            }
+            if (packet.isMulticast()) {
+                stats.multicastFrames++;
+            } else {
+                stats.unicastFrames++;
+            }
+        }
+    }
+
+    if (message) {
+        message->active = false;
+    }
+}
+
+void WiFiComm::coalesceNewest() {
+    TelemetryFrame& frame = overflowFrame;
+
+    // Only a slot loop() hasn't peeked can be rewritten, and only by a frame
+    // from the same sender. A delta older than it would roll fields back.
+    TelemetryFrame* newest = rxRing.reclaim();
+    int32_t step = 1;
+    if (newest) {
+        if (frame.hasSeq && newest->hasSeq) {
+            step = (int32_t)(frame.seq - newest->seq);
+        }
+        if (newest->senderAddress != frame.senderAddress || newest->senderPort != frame.senderPort ||
+            strcmp(newest->source, frame.source) != 0 || (!frame.keyframe && step <= 0)) {
+            rxRing.commit();
+            newest = nullptr;
+        }
+    }
+    if (!newest) {
+        // loop() may have made room meanwhile; if not, the overflow is counted
+        TelemetryFrame* slot = rxRing.acquire();
+        if (slot) {
+            *slot = frame;
+            rxRing.commit();
+        }
+        return;
+    }
+
+    // A delta keeps the fields the frame it replaces carried; a keyframe
+    // needs nothing from it. Over a sequence gap the result can't stand
+    // for a keyframe, so applyFrame() still asks for one.
+    if (!frame.keyframe) {
+        newest->data.merge(frame.data, frame.fields);
+        frame.data = newest->data;
+        frame.fields |= newest->fields;
+        frame.keyframe = newest->keyframe && step == 1;
+        frame.partial = frame.partial && newest->partial;
+    }
+    frame.coalesced = newest->coalesced < UINT16_MAX ? newest->coalesced + 1 : UINT16_MAX;
+    *newest = frame;
+    rxRing.commit();
+}
+
+WiFiReassembly* WiFiComm::handleFragment(const uint8_t* data, size_t length, uint32_t address, uint16_t port) {
+    unsigned long now = millis();
+    stats.fragments++;
+    expireFragments(now);
+
+    if (length <= WIFI_FRAG_HEADER) {
+        stats.truncated++;
+        return nullptr;
+    }
+    uint16_t messageId = data[1] | ((uint16_t)data[2] << 8);
+    uint8_t index = data[3];
+    uint8_t count = data[4];
+    size_t chunk = length - WIFI_FRAG_HEADER;
+
+    // Count an oversized message once, on its first fragment
+    if (count > WIFI_MAX_FRAGMENTS) {
+        if (index == 0) {
+            stats.truncated++;
+        }
+        return nullptr;
+    }
+    bool last = index == count - 1;
+    if (count == 0 || index >= count || chunk > WIFI_FRAG_CHUNK || (!last && chunk != WIFI_FRAG_CHUNK)) {
+        stats.truncated++;
+        return nullptr;
+    }
+
+    // The sender's message in progress, else a free slot, else the oldest
+    WiFiReassembly* slot = nullptr;
+    for (int i = 0; i < WIFI_REASSEMBLY_SLOTS; i++) {
+        WiFiReassembly& r = reassembly[i];
+        if (r.active && r.address == address && r.port == port && r.messageId == messageId && r.count == count) {
+            slot = &r;
+            break;
+        }
+    }
+    if (!slot) {
+        slot = &reassembly[0];
+        for (int i = 0; i < WIFI_REASSEMBLY_SLOTS; i++) {
+            if (!reassembly[i].active) {
+                slot = &reassembly[i];
+                break;
+            }
+            if ((long)(reassembly[i].startedAt - slot->startedAt) < 0) {
+                slot = &reassembly[i];
+            }
+        }
+        if (slot->active) {
+            stats.incomplete++;
+        }
+        slot->active = true;
+        slot->address = address;
+        slot->port = port;
+        slot->messageId = messageId;
+        slot->count = count;
+        slot->received = 0;
+        slot->length = 0;
+        slot->startedAt = now;
+    }
+
+    uint8_t bit = 1 << index;
+    if (slot->received & bit) {
+        return nullptr;  // Duplicate fragment
+    }
+    memcpy(slot->data + index * WIFI_FRAG_CHUNK, data + WIFI_FRAG_HEADER, chunk);
+    slot->received |= bit;
+    if (last) {
+        slot->length = index * WIFI_FRAG_CHUNK + chunk;
+    }
+
+    if (slot->received != (uint8_t)((1 << count) - 1)) {
+        return nullptr;
+    }
+    stats.reassembled++;
+    return slot;
+}
+
+void WiFiComm::expireFragments(unsigned long now) {
+    for (int i = 0; i < WIFI_REASSEMBLY_SLOTS; i++) {
+        if (reassembly[i].active && now - reassembly[i].startedAt > WIFI_REASSEMBLY_TIMEOUT) {
+            reassembly[i].active = false;
+            stats.incomplete++;
+        }
+    }
+}
+
 bool WiFiComm::receiveData(SystemData& data) {
-    int packetSize = udp.parsePacket();
-    if (packetSize > 0) {
-        int len = udp.read(packetBuffer, sizeof(packetBuffer) - 1);
-        if (len > 0) {
-            packetBuffer[len] = 0;
-            lastReceiveTime = millis();
-            return parseJSON(packetBuffer, data);
+    // Apply every queued frame in order (deltas depend on it); only the
+    // newest state leaves this call. With the jitter buffer on, timestamped
+    // frames wait there and are applied when their playout time comes.
+    // Hosts in multi-host mode have unrelated clocks, so they bypass it.
+    Config& cfg = Config::getInstance();
+    bool buffered = cfg.getJitterBuffer() && !cfg.isMultiHost();
+    uint32_t received = 0;
+    TelemetryFrame released;
+
+    noteQueueDepth(rxRing.size(), rxRing.capacity());
+    while (TelemetryFrame* frame = rxRing.peek()) {
+        notePeer(*frame);
+        countCoalesced(frame->coalesced);
+        if (buffered && frame->hasSendTime) {
+            if (playout.isFull() && playout.pop(millis(), released, true) && applyFrame(released, data)) {
+                received++;
+            }
+            playout.push(*frame);
+        } else if (applyFrame(*frame, data)) {
+            received++;
+        }
+        rxRing.release();
+    }
+    setOverflows(rxRing.overflows());
+
+    // Due frames leave in send-time order; all of them once it's turned off
+    unsigned long now = millis();
+    while (playout.pop(now, released, !buffered)) {
+        if (applyFrame(released, data)) {
+            received++;
+        }
+    }
+
+    if (received == 0) {
+        return false;
+    }
+
+    lastReceiveTime = millis();
+    countCoalesced(received - 1);
+    return true;
+}
+
+void WiFiComm::notePeer(const TelemetryFrame& frame) {
+    int slot = -1;
+    for (int i = 0; i < WIFI_FEEDBACK_PEERS; i++) {
+        if (peers[i].address == frame.senderAddress && peers[i].port == frame.senderPort) {
+            slot = i;
+            break;
+        }
+    }
+
+    // New sender: take the longest-quiet slot (free slots were never seen)
+    if (slot < 0) {
+        slot = 0;
+        for (int i = 1; i < WIFI_FEEDBACK_PEERS; i++) {
+            if ((long)(peers[i].lastSeen - peers[slot].lastSeen) < 0) {
+                slot = i;
+            }
         }
+        peers[slot].address = frame.senderAddress;
+        peers[slot].port = frame.senderPort;
     }
-    return false;
+    peers[slot].lastSeen = frame.receivedAt;
+}
+
+void WiFiComm::sendFeedback(const uint8_t* message, size_t length) {
+    // Replies go to the source port; senders read them on their send socket
+    unsigned long now = millis();
+    uint8_t active = 0;
+    for (int i = 0; i < WIFI_FEEDBACK_PEERS; i++) {
+        if (peers[i].address == 0 || now - peers[i].lastSeen > WIFI_PEER_TIMEOUT) {
+            continue;
+        }
+        active++;
+        if (connected && udp.writeTo(message, length, IPAddress(peers[i].address), peers[i].port) == length) {
+            stats.feedbackSent++;
+        }
+    }
+    stats.peers = active;
 }
 
 void WiFiComm::stop() {
-    MDNS.end();
-    udp.stop();
+    if (connected) {
+        onLinkDown();
+    }
+    if (eventRegistered) {
+        WiFi.removeEvent(eventId);
+        eventRegistered = false;
+    }
     WiFi.disconnect();
-    connected = false;
+    setState(WIFI_STATE_OFF);
 }
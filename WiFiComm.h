@@ -3,8 +3,97 @@
 
 #include "CommInterface.h"
 #include <WiFi.h>
-#include <WiFiUdp.h>
+#include <AsyncUDP.h>
 #include <ESPmDNS.h>
+#include <atomic>
+#include "SpscRing.h"
+#include "PlayoutBuffer.h"
+
+// Decoded frames queued between the network task and loop()
+#define WIFI_RX_RING_SIZE 4
+
+// Messages larger than one datagram arrive as fragments:
+//   [WIFI_FRAG_MAGIC][message id u16][index u8][count u8] payload
+// Every fragment but the last carries exactly WIFI_FRAG_CHUNK bytes, so
+// fragments land in place in whatever order they arrive. A message is keyed
+// by sender address, port and id; one not complete within the timeout is
+// dropped and its buffer reused.
+#define WIFI_FRAG_MAGIC           0xFD
+#define WIFI_FRAG_HEADER          5
+#define WIFI_FRAG_CHUNK           1200
+#define WIFI_MAX_FRAGMENTS        2      // About the 2 KB the other links take
+#define WIFI_MAX_MESSAGE          (WIFI_FRAG_CHUNK * WIFI_MAX_FRAGMENTS)
+#define WIFI_REASSEMBLY_SLOTS     2
+#define WIFI_REASSEMBLY_TIMEOUT   500    // ms
+
+// Senders that get feedback replies, and how long one stays without a frame (ms)
+#define WIFI_FEEDBACK_PEERS  8
+#define WIFI_PEER_TIMEOUT    10000
+
+// Link supervisor timing (ms)
+#define WIFI_CONNECT_TIMEOUT 10000
+#define WIFI_FAST_TIMEOUT    3000    // Directed connect to the cached AP
+#define WIFI_BACKOFF_MIN     1000
+#define WIFI_BACKOFF_MAX     60000
+
+enum WiFiLinkState {
+    WIFI_STATE_OFF,          // Not configured or stopped
+    WIFI_STATE_CONNECTING,
+    WIFI_STATE_CONNECTED,    // Associated and has an IP
+    WIFI_STATE_BACKOFF       // Waiting before the next attempt
+};
+
+struct WiFiLinkStats {
+    WiFiLinkState state;
+    uint32_t attempts;
+    uint32_t connects;
+    uint32_t disconnects;
+    uint32_t backoffMs;         // Current retry delay
+    uint8_t lastReason;         // Last disconnect reason code from the driver
+    unsigned long connectedSince;
+
+    // Fast association
+    uint32_t fastConnects;      // Connects via cached BSSID/channel
+    uint32_t fastFailures;      // Directed attempts that fell back to a scan
+    bool lastConnectFast;
+    unsigned long lastConnectMs;   // Attempt start to IP
+    unsigned long bootConnectMs;   // Boot to first IP
+
+    // Multicast fan-out
+    uint32_t multicastGroup;    // Joined group, 0 when listening unicast only
+    uint32_t unicastFrames;     // Datagrams received, by destination
+    uint32_t multicastFrames;
+
+    // Feedback replies
+    uint8_t peers;              // Senders heard within WIFI_PEER_TIMEOUT
+    uint32_t feedbackSent;
+
+    // Fragmented messages
+    uint32_t fragments;
+    uint32_t reassembled;
+    uint32_t incomplete;        // Timed out or evicted with fragments missing
+    uint32_t truncated;         // Larger than WIFI_MAX_MESSAGE, or malformed
+};
+
+// One message being reassembled (AsyncUDP task only)
+struct WiFiReassembly {
+    bool active;
+    uint32_t address;
+    uint16_t port;
+    uint16_t messageId;
+    uint8_t count;
+    uint8_t received;           // Bit per fragment index
+    uint16_t length;            // Known once the last fragment is in
+    unsigned long startedAt;
+    uint8_t data[WIFI_MAX_MESSAGE];
+};
+
+// A sender to reply to, keyed by source address and port
+struct WiFiPeer {
+    uint32_t address;
+    uint16_t port;
+    unsigned long lastSeen;
+};
 
 class WiFiComm : public CommInterface {
 public:
@@ -17,14 +106,55 @@ public:
     bool receiveData(SystemData& data) override;
     void stop() override;
 
+    const WiFiLinkStats& getStats() const { return stats; }
+    const PlayoutBuffer& getPlayout() const { return playout; }
+
+    static bool isMulticastAddress(const IPAddress& address) { return (address[0] & 0xF0) == 0xE0; }
+
 private:
-    WiFiUDP udp;
+    AsyncUDP udp;
     uint16_t localPort;
-    char packetBuffer[1024];
+    SpscRing<TelemetryFrame, WIFI_RX_RING_SIZE> rxRing;
+    TelemetryFrame overflowFrame;   // Decode target while rxRing is full (AsyncUDP task only)
     bool connected;
     unsigned long lastReceiveTime;
 
-    void connectToWiFi();
+    // Supervisor state; events arrive on the WiFi event task
+    WiFiLinkStats stats;
+    unsigned long stateSince;
+    wifi_event_id_t eventId;
+    bool eventRegistered;
+    std::atomic<bool> gotIPPending;
+    std::atomic<bool> disconnectPending;
+    std::atomic<bool> disconnectExpected;  // Next disconnect event is our own
+    std::atomic<uint8_t> disconnectReason;
+    bool fastAttempt;   // Current attempt is a directed connect
+    bool skipFast;      // Directed connect failed; scan on the next attempt
+
+    void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+    void setState(WiFiLinkState state);
+    void startConnect();
+    void startBackoff();
+    void connectFailed(const char* reason);
+    void saveAssociation();
+    void onLinkUp();
+    void onLinkDown();
+    void startListening();
+    void handlePacket(AsyncUDPPacket& packet);
+    void coalesceNewest();
+
+    // Fixed buffer pool; a lost fragment only holds its slot until the timeout
+    WiFiReassembly reassembly[WIFI_REASSEMBLY_SLOTS];
+    WiFiReassembly* handleFragment(const uint8_t* data, size_t length, uint32_t address, uint16_t port);
+    void expireFragments(unsigned long now);
+
+    // Optional jitter buffer between rxRing and applyFrame (loop() only)
+    PlayoutBuffer playout;
+
+    // Feedback goes to every sender heard recently (loop() only)
+    WiFiPeer peers[WIFI_FEEDBACK_PEERS];
+    void notePeer(const TelemetryFrame& frame);
+    void sendFeedback(const uint8_t* message, size_t length) override;
 };
 
 #endif
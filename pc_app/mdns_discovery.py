@@ -31,11 +31,15 @@ class ESP32ServiceListener(ServiceListener):
             addresses = [socket.inet_ntoa(addr) for addr in info.addresses]
             port = info.port
 
+            # Multicast group the display listens on, if any (TXT "group")
+            group = info.properties.get(b'group')
+
             device_info = {
                 'name': device_name,
                 'hostname': info.server.rstrip('.'),
                 'addresses': addresses,
                 'port': port,
+                'group': group.decode() if group else None,
                 'full_name': name
             }
 
@@ -77,7 +81,7 @@ class MDNSDiscovery:
             timeout: Time to wait for discovery in seconds
 
         Returns:
-            List of device dictionaries with keys: name, hostname, addresses, port
+            List of device dictionaries with keys: name, hostname, addresses, port, group
         """
         try:
             # Create zeroconf instance
@@ -206,6 +210,8 @@ if __name__ == "__main__":
             print(f"    Hostname: {device['hostname']}")
             print(f"    IP Address: {', '.join(device['addresses'])}")
             print(f"    Port: {device['port']}")
+            if device['group']:
+                print(f"    Multicast Group: {device['group']}")
     else:
         print("No devices found.")
         print("\nTroubleshooting:")
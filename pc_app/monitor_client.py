@@ -3,21 +3,27 @@
 ESP32 System Monitor - PC Client
 
 Collects system information from the PC and sends it to the ESP32 monitor
-via WiFi (UDP) or BLE.
+via WiFi (UDP or TCP), BLE or the USB-serial port.
 
 Requirements:
 - psutil: pip install psutil
 - For BLE: pip install bleak
+- For serial: pip install pyserial
 - For GPU monitoring: pip install gputil
 - For mDNS discovery: pip install zeroconf
 - For Windows temperature monitoring: pip install wmi (requires OpenHardwareMonitor or LibreHardwareMonitor running)
 """
 
+import binascii
+import ipaddress
 import json
 import socket
+import struct
 import time
 import argparse
 import platform
+import re
+import select
 import psutil
 
 # Try to import mDNS discovery (optional)
@@ -40,8 +46,53 @@ def log_print(*args, **kwargs):
 class SystemMonitor:
     """Collects system information from the PC"""
 
-    def __init__(self):
+    def __init__(self, counters=False, sensors=False):
         self.cpu_name = self._get_cpu_name()
+        self.counters = counters
+        self.sensors = sensors
+
+    def get_counters(self):
+        """Raw byte and operation counters (COUNTER_NAMES); the device derives the rates"""
+        net_io = psutil.net_io_counters()
+        counters = {"net_tx": net_io.bytes_sent, "net_rx": net_io.bytes_recv}
+        disk_io = psutil.disk_io_counters()
+        if disk_io:
+            counters.update({"disk_read": disk_io.read_bytes, "disk_write": disk_io.write_bytes,
+                             "disk_reads": disk_io.read_count, "disk_writes": disk_io.write_count})
+        return counters
+
+    def _use_counters(self, data):
+        """With counters on, send them in place of the averaged network rates"""
+        if self.counters:
+            data.pop("network", None)
+            data["counters"] = self.get_counters()
+        return data
+
+    def get_sensors(self):
+        """Fans and any GPUs past the first as named sensors (SENSOR_MAX at most)"""
+        sensors = {}
+        try:
+            for chip, fans in (psutil.sensors_fans() or {}).items():
+                for i, fan in enumerate(fans):
+                    sensors[sensor_name("fan", fan.label or f"{chip}{i}")] = {"value": fan.current, "unit": "rpm"}
+        except AttributeError:
+            pass  # Fan readings are Linux only
+        try:
+            import GPUtil
+            for gpu in GPUtil.getGPUs()[1:]:
+                sensors[f"gpu{gpu.id}.usage"] = {"value": round(gpu.load * 100, 1), "unit": "%"}
+                sensors[f"gpu{gpu.id}.temp"] = {"value": round(gpu.temperature, 1), "unit": "C"}
+        except ImportError:
+            pass
+        return dict(list(sensors.items())[:SENSOR_MAX])
+
+    def _use_sensors(self, data):
+        """With sensors on, add them to the snapshot"""
+        if self.sensors:
+            sensors = self.get_sensors()
+            if sensors:
+                data["sensors"] = sensors
+        return data
 
     def _get_cpu_name(self):
         """Get CPU name"""
@@ -67,10 +118,40 @@ class SystemMonitor:
             pass
         return "Unknown CPU"
 
-    def get_system_data(self):
-        """Collect all system data"""
+    def get_sample(self):
+        """Quick, non-blocking reading of the batched fields (see BATCH_FIELDS)"""
+        now = time.time()
+        net_io = psutil.net_io_counters()
+        if not hasattr(self, '_sample_net_io'):
+            self._sample_net_io = net_io
+            self._sample_time = now
+
+        time_delta = now - self._sample_time
+        if time_delta > 0:
+            upload_speed = (net_io.bytes_sent - self._sample_net_io.bytes_sent) / time_delta / 1024
+            download_speed = (net_io.bytes_recv - self._sample_net_io.bytes_recv) / time_delta / 1024
+        else:
+            upload_speed = 0
+            download_speed = 0
+
+        self._sample_net_io = net_io
+        self._sample_time = now
+
+        return {
+            "t": now,
+            "cpu": round(psutil.cpu_percent(interval=None), 1),
+            "mem": round(psutil.virtual_memory().percent, 1),
+            "up": round(upload_speed, 2),
+            "down": round(download_speed, 2),
+        }
+
+    def get_system_data(self, samples=None):
+        """Collect all system data; with samples, CPU usage is their average"""
         # CPU info
-        cpu_usage = psutil.cpu_percent(interval=0.5)
+        if samples:
+            cpu_usage = sum(s["cpu"] for s in samples) / len(samples)
+        else:
+            cpu_usage = psutil.cpu_percent(interval=0.5)
         cpu_temp = self._get_cpu_temp()
 
         # Memory info
@@ -150,7 +231,63 @@ class SystemMonitor:
             }
         }
 
-        return data
+        return self._use_sensors(self._use_counters(data))
+
+    def get_group_data(self, groups):
+        """Collect only the fields of the given groups (see FIELD_GROUPS)
+
+        Nothing here blocks, so the load group can be read at 10 Hz. The GPU
+        is read with the thermal group; load frames in between repeat its
+        last usage figure.
+        """
+        data = {}
+        if "thermal" in groups or not hasattr(self, '_gpu_usage'):
+            self._gpu_usage = 0
+            try:
+                import GPUtil
+                gpus = GPUtil.getGPUs()
+                if gpus:
+                    self._gpu_usage = gpus[0].load * 100
+            except ImportError:
+                pass
+
+        if "load" in groups:
+            sample = self.get_sample()
+            memory = psutil.virtual_memory()
+            data["cpu"] = {"usage": sample["cpu"]}
+            data["memory"] = {"used": round(memory.used / (1024**3), 1),
+                              "percent": round(memory.percent, 1)}
+            data["network"] = {"upload": sample["up"], "download": sample["down"]}
+            data["gpu"] = {"usage": round(self._gpu_usage, 1)}
+
+        if "thermal" in groups:
+            all_temps = self._get_all_temperatures()
+            data.setdefault("cpu", {})["temp"] = round(all_temps['cpu'], 1)
+            data.setdefault("gpu", {})["temp"] = round(all_temps['gpu'], 1)
+            data["temperatures"] = {
+                "cpu": round(all_temps['cpu'], 1),
+                "gpu": round(all_temps['gpu'], 1),
+                "motherboard": round(all_temps['motherboard'], 1),
+                "disks": all_temps['disk']
+            }
+
+        if "capacity" in groups:
+            memory = psutil.virtual_memory()
+            disk = psutil.disk_usage('/')
+            data.setdefault("memory", {})["total"] = round(memory.total / (1024**3), 1)
+            data["disk"] = {
+                "used": round(disk.used / (1024**3), 1),
+                "total": round(disk.total / (1024**3), 1),
+                "percent": round(disk.percent, 1)
+            }
+
+        if "info" in groups:
+            data.setdefault("cpu", {})["name"] = self.cpu_name
+
+        # Counters go with the load group, sensors with the thermal one
+        if "thermal" in groups:
+            data = self._use_sensors(data)
+        return self._use_counters(data) if "load" in groups else data
 
     def _get_cpu_temp(self):
         """Get CPU temperature (platform dependent)"""
@@ -260,36 +397,603 @@ class SystemMonitor:
         return temps
 
 
+# Binary frame layout (CommInterface.h): header, then fields in FIELD_* bit order
+BINARY_MAGIC = 0xB1
+BINARY_FLAG_KEYFRAME = 0x01
+BINARY_FLAG_SEQ = 0x02
+BINARY_FLAG_TS = 0x04
+BINARY_FIELDS = [
+    ('cpu', 'usage'), ('cpu', 'temp'), ('cpu', 'name'),
+    ('memory', 'used'), ('memory', 'total'), ('memory', 'percent'),
+    ('disk', 'used'), ('disk', 'total'), ('disk', 'percent'),
+    ('network', 'upload'), ('network', 'download'),
+    ('gpu', 'usage'), ('gpu', 'temp'),
+    ('temperatures', 'motherboard'),
+    ('disks', 'temp'), ('disks', 'name'),
+    ('disk', 'read'), ('disk', 'write'),
+]
+
+
+# Batched history fields with their bit in the device's HistoryField order
+BINARY_FLAG_BATCH = 0x08
+BINARY_FLAG_HOST = 0x10
+BINARY_FLAG_PARTIAL = 0x20
+BINARY_FLAG_COUNTERS = 0x40
+
+# Raw counters in the device's CounterId order (CounterRates.h), sent as u64
+COUNTER_NAMES = ['net_tx', 'net_rx', 'disk_read', 'disk_write', 'disk_reads', 'disk_writes']
+HISTORY_FIELDS = ['cpu', 'mem', 'disk', 'up', 'down']
+
+# Extra sensors (MetricRegistry.h): names up to 23 characters, a few per frame
+SENSOR_NAME_MAX = 23
+SENSOR_MAX = 8
+
+
+def sensor_name(prefix, label):
+    """Registry key for a sensor label, e.g. ("fan", "CPU Fan") -> fan.cpu_fan"""
+    label = re.sub(r'[^a-z0-9]+', '_', label.lower()).strip('_')
+    return f"{prefix}.{label}"[:SENSOR_NAME_MAX]
+
+BATCH_FIELDS = ['cpu', 'mem', 'up', 'down']
+BATCH_MAX = 10   # HISTORY_BATCH_MAX in HistoryStore.h
+
+
+# Compressed payload (FrameCompression.h): [0xC1][dictionary id][length u16 LE]
+# then an LZ4 block that may copy from COMPRESSION_DICT as preceding history.
+# The dictionary must match FRAME_DICTIONARY on the device byte for byte.
+COMPRESSED_MAGIC = 0xC1
+COMPRESSION_DICT_ID = 1
+COMPRESSION_DICT = (
+    b'{"cpu":{"usage":,"temp":,"name":"Intel(R) Core(TM) AMD Ryzen Processor"},'
+    b'"memory":{"used":,"total":,"percent":},"disk":{"used":,"total":,"percent":},'
+    b'"network":{"upload":,"download":},"gpu":{"usage":,"temp":},'
+    b'"temperatures":{"cpu":,"gpu":,"motherboard":,"disks":[{"name":"nvme0n1","temp":}]},'
+    b'"type":"delta","type":"key","seq":,"ts":,"host":"",'
+    b'"samples":{"fields":["cpu","mem","disk","up","down"],"data":[[-'
+)
+COMPRESSED_MAX = 2048
+
+
+# Field groups (SystemData.h), each refreshed at its own rate in multi-rate
+# mode, with the default seconds between updates. The info group (names)
+# only travels in keyframes unless given an interval.
+FIELD_GROUPS = ["load", "thermal", "capacity", "info"]
+GROUP_INTERVALS = {"load": 0.1, "thermal": 1.0, "capacity": 10.0, "info": None}
+
+
+def _lz4_length(out, n):
+    """Append the continuation bytes of an LZ4 length"""
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def _lz4_sequence(out, literals, offset=0, match=0):
+    """Append one LZ4 sequence; match 0 ends the block with literals only"""
+    lit = len(literals)
+    extra = match - 4
+    out.append((min(lit, 15) << 4) | (min(extra, 15) if match else 0))
+    if lit >= 15:
+        _lz4_length(out, lit - 15)
+    out += literals
+    if match:
+        out += struct.pack('<H', offset)
+        if extra >= 15:
+            _lz4_length(out, extra - 15)
+
+
+def lz4_compress(data, dictionary=b''):
+    """Greedy LZ4 block compression, with dictionary as preceding history"""
+    buf = dictionary + data
+    start = len(dictionary)
+    end = len(buf)
+
+    table = {}
+    for i in range(start - 3):
+        table[buf[i:i + 4]] = i
+
+    out = bytearray()
+    anchor = i = start
+    # LZ4 ends every block with at least 5 literals and starts no match in
+    # the last 12 bytes
+    while i < end - 12:
+        key = buf[i:i + 4]
+        ref = table.get(key)
+        table[key] = i
+        if ref is None or i - ref > 0xFFFF:
+            i += 1
+            continue
+        length = 4
+        while i + length < end - 5 and buf[ref + length] == buf[i + length]:
+            length += 1
+        _lz4_sequence(out, buf[anchor:i], i - ref, length)
+        i += length
+        anchor = i
+    _lz4_sequence(out, buf[anchor:end])
+    return bytes(out)
+
+
+def compress_payload(payload):
+    """Compress an encoded frame; returns it unchanged if that doesn't help"""
+    if len(payload) > COMPRESSED_MAX:
+        return payload
+    block = lz4_compress(payload, COMPRESSION_DICT)
+    header = struct.pack('<BBH', COMPRESSED_MAGIC, COMPRESSION_DICT_ID, len(payload))
+    if len(header) + len(block) >= len(payload):
+        return payload
+    return header + block
+
+
+def pack_binary(frame):
+    """Encode a frame dict in the device's binary layout"""
+    flags = 0
+    if frame.get("type", "key") == "key":
+        flags |= BINARY_FLAG_KEYFRAME
+    if "seq" in frame:
+        flags |= BINARY_FLAG_SEQ
+    if "ts" in frame:
+        flags |= BINARY_FLAG_TS
+    if frame.get("partial"):
+        flags |= BINARY_FLAG_PARTIAL
+
+    fields = 0
+    body = b''
+    if "host" in frame:
+        flags |= BINARY_FLAG_HOST
+        raw = str(frame["host"]).encode()[:23]
+        body += bytes([len(raw)]) + raw
+
+    for bit, (section, key) in enumerate(BINARY_FIELDS):
+        if section == 'disks':
+            # First disk only; an empty list clears both fields
+            disks = frame.get('temperatures', {}).get('disks')
+            if disks is None:
+                continue
+            value = disks[0].get(key) if disks else ('' if key == 'name' else 0)
+        else:
+            value = frame.get(section, {}).get(key)
+        if value is None:
+            continue
+
+        fields |= 1 << bit
+        if key == 'name':
+            raw = str(value).encode()[:255]
+            body += bytes([len(raw)]) + raw
+        else:
+            body += struct.pack('<f', float(value))
+
+    batch = frame.get("samples")
+    if batch:
+        # Values go in HistoryField bit order, whatever order the JSON names use
+        flags |= BINARY_FLAG_BATCH
+        columns = {name: i + 1 for i, name in enumerate(batch["fields"])}
+        present = [name for name in HISTORY_FIELDS if name in columns]
+        mask = sum(1 << HISTORY_FIELDS.index(name) for name in present)
+        body += bytes([len(batch["data"]), mask])
+        for row in batch["data"]:
+            body += struct.pack('<h', row[0])
+            body += b''.join(struct.pack('<f', float(row[columns[name]])) for name in present)
+
+    counters = frame.get("counters")
+    if counters:
+        flags |= BINARY_FLAG_COUNTERS
+        present = [name for name in COUNTER_NAMES if name in counters]
+        body += bytes([sum(1 << COUNTER_NAMES.index(name) for name in present)])
+        body += b''.join(struct.pack('<Q', counters[name] & 0xFFFFFFFFFFFFFFFF) for name in present)
+
+    header = struct.pack('<BBIII', BINARY_MAGIC, flags, frame.get("seq", 0),
+                         frame.get("ts", 0), fields)
+    return header + body
+
+
+class FrameEncoder:
+    """Wraps snapshots into keyframe/delta frames
+
+    Every frame carries a sequence number ("seq") and the send time in
+    milliseconds ("ts", low 32 bits) so the device can measure loss,
+    reordering, jitter and latency.
+
+    A keyframe carries every field. A delta frame carries only the fields that
+    changed since the previous frame. Keyframes are sent every
+    keyframe_interval seconds, on request, and whenever delta mode is off.
+
+    Samples taken between frames ride along as a batch ("samples"), each
+    with its offset from "ts" in milliseconds, so the device graphs them at
+    their original spacing.
+
+    With host_id set, every frame names its sender ("host") so a display in
+    multi-host mode can tell machines apart without relying on addresses.
+
+    With compress set, payloads are LZ4-compressed against a dictionary of
+    the known keys (BLE only on the device side).
+
+    With group_intervals set (multi-rate mode), each field group has its own
+    period. due_groups() names the groups to collect for the next frame, and
+    the snapshot passed to encode() holds only those. Between keyframes such
+    a frame is a partial delta ("partial": true): it carries its groups
+    whole, and the device keeps the age of each group.
+    """
+
+    def __init__(self, delta=False, keyframe_interval=10.0, binary=False, host_id=None,
+                 compress=False, group_intervals=None):
+        self.delta = delta or bool(group_intervals)
+        self.keyframe_interval = keyframe_interval
+        self.binary = binary
+        self.host_id = host_id
+        self.compress = compress
+        self.seq = 0
+        self._last = None
+        self._last_keyframe_time = 0
+        self._keyframe_requested = True
+        self.group_intervals = group_intervals
+        self._group_sent = {}
+        self._due = []
+        self._due_keyframe = False
+
+    def request_keyframe(self):
+        """Force the next frame to be a keyframe"""
+        self._keyframe_requested = True
+
+    def tick(self):
+        """Seconds between frames: the shortest group period in multi-rate mode"""
+        return min(interval for interval in self.group_intervals.values() if interval)
+
+    def due_groups(self):
+        """Field groups the next frame carries (multi-rate mode); all for a keyframe"""
+        now = time.time()
+        self._due_keyframe = self._keyframe_due(now)
+        if self._due_keyframe:
+            self._due = list(FIELD_GROUPS)
+        else:
+            self._due = [name for name in FIELD_GROUPS
+                         if self.group_intervals.get(name) and
+                         now - self._group_sent.get(name, 0) >= self.group_intervals[name]]
+        return self._due
+
+    def _keyframe_due(self, now):
+        return (not self.delta or self._keyframe_requested or self._last is None or
+                now - self._last_keyframe_time >= self.keyframe_interval)
+
+    def encode(self, data, samples=None):
+        """Return the frame (dict) to send for this snapshot"""
+        now = time.time()
+        if self.group_intervals:
+            # Decided with due_groups(): the snapshot holds only those groups
+            keyframe = self._due_keyframe
+            for name in self._due:
+                self._group_sent[name] = now
+        else:
+            keyframe = self._keyframe_due(now)
+
+        if keyframe:
+            frame = dict(data)
+            frame["type"] = "key"
+            self._last_keyframe_time = now
+            self._keyframe_requested = False
+        elif self.group_intervals:
+            frame = dict(data)
+            frame["type"] = "delta"
+            frame["partial"] = True
+        else:
+            frame = self._diff(data, self._last)
+            frame["type"] = "delta"
+            # Counters go whole every time: an idle counter still needs samples
+            if "counters" in data:
+                frame["counters"] = data["counters"]
+
+        now_ms = int(time.time() * 1000)
+        frame["seq"] = self.seq
+        frame["ts"] = now_ms & 0xFFFFFFFF
+        if self.host_id:
+            frame["host"] = self.host_id
+        self.seq = (self.seq + 1) & 0xFFFFFFFF
+        self._last = data
+
+        if samples:
+            rows = []
+            for sample in samples[-BATCH_MAX:]:
+                offset = max(-32768, min(0, int(sample["t"] * 1000) - now_ms))
+                rows.append([offset] + [sample[name] for name in BATCH_FIELDS])
+            frame["samples"] = {"fields": BATCH_FIELDS, "data": rows}
+        return frame
+
+    def serialize(self, data, samples=None):
+        """Encode this snapshot (and any batched samples) and return the bytes to send"""
+        frame = self.encode(data, samples)
+        if self.binary:
+            payload = pack_binary(frame)
+        else:
+            payload = json.dumps(frame, separators=(',', ':')).encode()
+        return compress_payload(payload) if self.compress else payload
+
+    @staticmethod
+    def _diff(new, old):
+        """Fields of new that differ from old; lists are sent whole"""
+        changed = {}
+        for key, value in new.items():
+            prev = old.get(key)
+            if isinstance(value, dict) and isinstance(prev, dict):
+                sub = FrameEncoder._diff(value, prev)
+                if sub:
+                    changed[key] = sub
+            elif value != prev:
+                changed[key] = value
+        return changed
+
+
+# Feedback from the device (CommInterface.h): requested sample period, load
+# and queue state, about once a second
+FEEDBACK_MAGIC = 0xFB
+FEEDBACK_FORMAT = '<BBHHHHBB'
+FEEDBACK_FLAG_KEYFRAME = 0x01
+FEEDBACK_FLAG_OVERLOAD = 0x02
+FEEDBACK_TIMEOUT = 5.0
+
+
+def parse_feedback(payload):
+    """Decode a feedback message, or None if payload isn't one"""
+    if len(payload) < struct.calcsize(FEEDBACK_FORMAT) or payload[0] != FEEDBACK_MAGIC:
+        return None
+    (_, flags, interval, desired, render, budget,
+     queue, capacity) = struct.unpack_from(FEEDBACK_FORMAT, payload)
+    return {
+        "interval": interval / 1000.0,
+        "desired": desired / 1000.0,
+        "render_ms": render,
+        "budget_ms": budget,
+        "queue": queue,
+        "capacity": capacity,
+        "keyframe": bool(flags & FEEDBACK_FLAG_KEYFRAME),
+        "overloaded": bool(flags & FEEDBACK_FLAG_OVERLOAD),
+    }
+
+
+class SendPacer:
+    """Adapts the send interval to device feedback
+
+    The interval never drops below the one given on the command line; a
+    display stretches it when configured for a slower rate (setrate) or
+    while it is overloaded. With several displays (multicast) the slowest
+    one sets the pace. A display not heard from for FEEDBACK_TIMEOUT
+    seconds no longer counts.
+    """
+
+    def __init__(self, interval, encoder):
+        self.base = interval
+        self.encoder = encoder
+        self.displays = {}
+        self._current = interval
+
+    def handle(self, payload, peer):
+        """Apply one message received from the device"""
+        feedback = parse_feedback(payload)
+        if feedback is None:
+            return
+        self.displays[peer] = (time.time(), feedback)
+        if feedback["keyframe"]:
+            self.encoder.request_keyframe()
+
+    def interval(self):
+        """Seconds to wait before the next frame"""
+        now = time.time()
+        self.displays = {peer: entry for peer, entry in self.displays.items()
+                         if now - entry[0] < FEEDBACK_TIMEOUT}
+        interval = max([self.base] + [fb["interval"] for _, fb in self.displays.values()])
+
+        if interval != self._current:
+            overloaded = any(fb["overloaded"] for _, fb in self.displays.values())
+            log_print(f"Send interval {self._current:g}s -> {interval:g}s"
+                      f"{' (display overloaded)' if overloaded else ''}")
+            self._current = interval
+        return interval
+
+
+def is_multicast(host):
+    """True if host is an IPv4 multicast address"""
+    try:
+        return ipaddress.ip_address(host).is_multicast
+    except ValueError:
+        return False
+
+
 class WiFiSender:
-    """Sends data via WiFi (UDP)"""
+    """Sends data via WiFi (UDP)
 
-    def __init__(self, host, port):
+    host may be a multicast group (see the device's setmulticast), in which
+    case one datagram reaches every display that joined it.
+
+    Payloads over FRAG_CHUNK bytes are split into fragments with a 5-byte
+    header: magic 0xFD, message id (u16 little-endian), index and count.
+    Every fragment but the last carries exactly FRAG_CHUNK bytes.
+    """
+
+    FRAG_MAGIC = 0xFD
+    FRAG_CHUNK = 1200
+    MAX_FRAGMENTS = 2   # WIFI_MAX_FRAGMENTS in WiFiComm.h
+
+    def __init__(self, host, port, ttl=1):
         self.host = host
         self.port = port
+        self.message_id = 0
         self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
-        log_print(f"WiFi sender initialized: {host}:{port}")
+        if is_multicast(host):
+            self.sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, ttl)
+            log_print(f"WiFi sender initialized: multicast group {host}:{port} (TTL {ttl})")
+        else:
+            log_print(f"WiFi sender initialized: {host}:{port}")
+
+    def _fragments(self, payload):
+        """Split payload into fragment datagrams, or one raw datagram if it fits"""
+        if len(payload) <= self.FRAG_CHUNK:
+            return [payload]
 
-    def send(self, data):
-        """Send JSON data via UDP"""
+        parts = [payload[i:i + self.FRAG_CHUNK] for i in range(0, len(payload), self.FRAG_CHUNK)]
+        if len(parts) > self.MAX_FRAGMENTS:
+            raise ValueError(f"message too large for the device ({len(payload)} bytes, "
+                             f"max {self.FRAG_CHUNK * self.MAX_FRAGMENTS})")
+
+        msg_id = self.message_id
+        self.message_id = (self.message_id + 1) & 0xFFFF
+        return [struct.pack('<BHBB', self.FRAG_MAGIC, msg_id, index, len(parts)) + part
+                for index, part in enumerate(parts)]
+
+    def send(self, payload):
+        """Send one encoded frame via UDP"""
         try:
-            json_data = json.dumps(data)
-            self.sock.sendto(json_data.encode(), (self.host, self.port))
+            for datagram in self._fragments(payload):
+                self.sock.sendto(datagram, (self.host, self.port))
             return True
         except Exception as e:
             log_print(f"Error sending data: {e}")
             return False
 
+    def poll(self):
+        """Feedback replies waiting on the send socket, as (payload, peer)"""
+        messages = []
+        while select.select([self.sock], [], [], 0)[0]:
+            try:
+                payload, peer = self.sock.recvfrom(512)
+            except OSError:
+                break
+            messages.append((payload, peer))
+        return messages
+
     def close(self):
         self.sock.close()
 
 
+class TCPSender:
+    """Sends length-prefixed frames over a persistent TCP connection"""
+
+    def __init__(self, host, port):
+        self.host = host
+        self.port = port
+        self.sock = None
+        self.rx = b''
+        log_print(f"TCP sender initialized: {host}:{port}")
+
+    def send(self, payload):
+        """Send one encoded frame; reconnects on the next call after an error"""
+        try:
+            if self.sock is None:
+                self.sock = socket.create_connection((self.host, self.port), timeout=5)
+                self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+                log_print(f"TCP connected to {self.host}:{self.port}")
+            self.sock.sendall(struct.pack('>H', len(payload)) + payload)
+            return True
+        except OSError as e:
+            log_print(f"Error sending data: {e}")
+            self.close()
+            return False
+
+    def poll(self):
+        """Feedback the device wrote back, framed like the frames we send"""
+        messages = []
+        try:
+            while self.sock and select.select([self.sock], [], [], 0)[0]:
+                data = self.sock.recv(512)
+                if not data:
+                    self.close()
+                    break
+                self.rx += data
+        except OSError:
+            self.close()
+
+        while len(self.rx) >= 2:
+            length = struct.unpack_from('>H', self.rx)[0]
+            if len(self.rx) < 2 + length:
+                break
+            messages.append((self.rx[2:2 + length], self.host))
+            self.rx = self.rx[2 + length:]
+        return messages
+
+    def close(self):
+        if self.sock:
+            self.sock.close()
+            self.sock = None
+        self.rx = b''
+
+
+def cobs_encode(data):
+    """Consistent Overhead Byte Stuffing: the result contains no 0x00 bytes"""
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(byte)
+            if len(block) == 254:
+                out.append(0xFF)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+class SerialSender:
+    """Sends COBS frames over the serial port shared with the device CLI
+
+    Each frame is 0x00, COBS(payload + CRC-16/CCITT-FALSE little-endian),
+    0x00. Any path pyserial can open works, including a Linux
+    pseudo-terminal (see README).
+    """
+
+    def __init__(self, port, baud):
+        import serial
+        self.serial = serial.Serial(port, baud, timeout=0)
+        log_print(f"Serial sender initialized: {port} @ {baud}")
+
+    def send(self, payload):
+        """Send one encoded frame"""
+        try:
+            crc = binascii.crc_hqx(payload, 0xFFFF)
+            frame = cobs_encode(payload + struct.pack('<H', crc))
+            self.serial.write(b'\x00' + frame + b'\x00')
+
+            # The device CLI shares the port; show what it prints
+            text = self.serial.read(self.serial.in_waiting or 0)
+            if text:
+                log_print(text.decode(errors='replace'), end='')
+            return True
+        except Exception as e:
+            log_print(f"Error sending data: {e}")
+            return False
+
+    def poll(self):
+        """The port carries CLI text, so the device sends no feedback here"""
+        return []
+
+    def close(self):
+        self.serial.close()
+
+
 class BLESender:
-    """Sends data via BLE"""
+    """Sends data via BLE
+
+    Messages that fit in one ATT write are sent as-is. Larger messages are
+    split into fragments with a 3-byte header: magic 0xFE, message id and
+    fragment index (bit 7 marks the last fragment). Writes go without
+    response so several fit in one connection interval.
+    """
+
+    FRAG_MAGIC = 0xFE
+    FRAG_LAST = 0x80
+    FRAG_HEADER = 3
+    MAX_FRAGMENTS = 128
 
     def __init__(self, device_name):
         self.device_name = device_name
         self.client = None
         self.characteristic_uuid = "beb5483e-36e1-4688-b7f5-ea07361b26a8"
+        self.feedback_uuid = "beb5483e-36e1-4688-b7f5-ea07361b26a9"
+        self.max_write = 20
+        self.message_id = 0
+        self.feedback = []
         log_print(f"BLE sender initialized for device: {device_name}")
         log_print("Note: BLE support requires 'bleak' library (pip install bleak)")
 
@@ -313,21 +1017,62 @@ class BLESender:
 
         self.client = BleakClient(device_address)
         await self.client.connect()
-        log_print("Connected to BLE device")
+
+        # BlueZ only reports the negotiated MTU after an explicit exchange
+        if hasattr(self.client, "_acquire_mtu"):
+            try:
+                await self.client._acquire_mtu()
+            except Exception:
+                pass
+        mtu = getattr(self.client, "mtu_size", 23) or 23
+        self.max_write = max(20, mtu - 3)
+        log_print(f"Connected to BLE device (MTU {mtu}, {self.max_write} bytes per write)")
+
+        # Older firmware has no feedback characteristic; send at a fixed rate then
+        try:
+            await self.client.start_notify(self.feedback_uuid,
+                                           lambda _, data: self.feedback.append(bytes(data)))
+        except Exception as e:
+            log_print(f"Device feedback unavailable: {e}")
         return True
 
-    async def send(self, data):
-        """Send JSON data via BLE"""
+    def poll(self):
+        """Feedback notifications received since the last call"""
+        messages = [(payload, self.device_name) for payload in self.feedback]
+        self.feedback = []
+        return messages
+
+    def _fragments(self, payload):
+        """Split payload into framed writes, or one raw write if it fits"""
+        if len(payload) <= self.max_write:
+            return [payload]
+
+        chunk = self.max_write - self.FRAG_HEADER
+        parts = [payload[i:i + chunk] for i in range(0, len(payload), chunk)]
+        if len(parts) > self.MAX_FRAGMENTS:
+            raise ValueError(f"message too large for BLE framing ({len(payload)} bytes)")
+
+        msg_id = self.message_id
+        self.message_id = (self.message_id + 1) & 0xFF
+        writes = []
+        for index, part in enumerate(parts):
+            flags = index | (self.FRAG_LAST if index == len(parts) - 1 else 0)
+            writes.append(bytes([self.FRAG_MAGIC, msg_id, flags]) + part)
+        return writes
+
+    async def send(self, payload):
+        """Send one encoded frame via BLE"""
         try:
             if not self.client or not self.client.is_connected:
                 log_print("Not connected to BLE device")
                 return False
 
-            json_data = json.dumps(data)
-            await self.client.write_gatt_char(
-                self.characteristic_uuid,
-                json_data.encode()
-            )
+            for chunk in self._fragments(payload):
+                await self.client.write_gatt_char(
+                    self.characteristic_uuid,
+                    chunk,
+                    response=False
+                )
             return True
         except Exception as e:
             log_print(f"Error sending data: {e}")
@@ -338,15 +1083,57 @@ class BLESender:
             await self.client.disconnect()
 
 
-async def run_ble_mode(device_name, interval):
+def describe(data):
+    """Short summary of a snapshot for the log; partial snapshots show what they carry"""
+    parts = []
+    for label, section, key, unit in (("CPU", "cpu", "usage", "%"), ("MEM", "memory", "percent", "%"),
+                                      ("DISK", "disk", "percent", "%"), ("TEMP", "cpu", "temp", "C")):
+        value = data.get(section, {}).get(key)
+        if value is not None:
+            parts.append(f"{label}={value}{unit}")
+    return ", ".join(parts)
+
+
+def collect(monitor, encoder, interval, batch):
+    """Snapshot and batched samples for the next frame
+
+    In multi-rate mode only the groups due are read, and there is no batch.
+    """
+    if encoder.group_intervals:
+        return monitor.get_group_data(encoder.due_groups()), None
+    samples = collect_samples(monitor, interval, batch) if batch > 1 else None
+    return monitor.get_system_data(samples), samples
+
+
+def collect_samples(monitor, interval, batch):
+    """Take batch samples spaced evenly over interval seconds"""
+    samples = []
+    for _ in range(batch):
+        time.sleep(interval / batch)
+        samples.append(monitor.get_sample())
+    return samples
+
+
+async def collect_samples_async(monitor, interval, batch):
+    """collect_samples without blocking the BLE event loop"""
+    import asyncio
+    samples = []
+    for _ in range(batch):
+        await asyncio.sleep(interval / batch)
+        samples.append(monitor.get_sample())
+    return samples
+
+
+async def run_ble_mode(device_name, interval, encoder, batch=1, counters=False, sensors=False):
     """Run in BLE mode"""
     try:
+        import asyncio
         from bleak import BleakClient
     except ImportError:
         log_print("Error: bleak library not installed. Install with: pip install bleak")
         return
 
-    monitor = SystemMonitor()
+    monitor = SystemMonitor(counters, sensors)
     sender = BLESender(device_name)
 
     if not await sender.connect():
@@ -355,56 +1142,116 @@ async def run_ble_mode(device_name, interval):
     log_print(f"\nSending system data via BLE every {interval} seconds...")
     log_print("Press Ctrl+C to stop\n")
 
+    pacer = SendPacer(interval, encoder)
     try:
         while True:
-            data = monitor.get_system_data()
-            if await sender.send(data):
-                log_print(f"Sent: CPU={data['cpu']['usage']}%, "
-                          f"MEM={data['memory']['percent']}%, "
-                          f"DISK={data['disk']['percent']}%")
-            time.sleep(interval)
+            if encoder.group_intervals:
+                data, samples = monitor.get_group_data(encoder.due_groups()), None
+            else:
+                samples = await collect_samples_async(monitor, pacer.interval(), batch) if batch > 1 else None
+                data = monitor.get_system_data(samples)
+            if await sender.send(encoder.serialize(data, samples)):
+                log_print(f"Sent: {describe(data)}")
+            for payload, peer in sender.poll():
+                pacer.handle(payload, peer)
+            if batch <= 1:
+                await asyncio.sleep(pacer.interval())
     except KeyboardInterrupt:
         log_print("\nStopping...")
     finally:
         await sender.close()
 
 
-def run_wifi_mode(host, port, interval):
-    """Run in WiFi mode"""
-    monitor = SystemMonitor()
-    sender = WiFiSender(host, port)
+def run_serial_mode(port, baud, interval, encoder, batch=1, counters=False, sensors=False):
+    """Run in serial mode"""
+    try:
+        sender = SerialSender(port, baud)
+    except ImportError:
+        log_print("Error: pyserial library not installed. Install with: pip install pyserial")
+        return
+    run_loop(sender, interval, encoder, "serial", batch, counters, sensors)
+
+
+def run_loop(sender, interval, encoder, label, batch=1, counters=False, sensors=False):
+    """Send a snapshot every interval seconds until interrupted
+
+    With batch > 1 the interval is spent taking that many samples, which are
+    sent together with the snapshot. Device feedback may stretch the interval
+    (see SendPacer).
+    """
+    monitor = SystemMonitor(counters, sensors)
+    pacer = SendPacer(interval, encoder)
 
-    log_print(f"\nSending system data via WiFi every {interval} seconds...")
+    log_print(f"\nSending system data via {label} every {interval} seconds...")
     log_print("Press Ctrl+C to stop\n")
 
     try:
         while True:
-            data = monitor.get_system_data()
-            if sender.send(data):
-                log_print(f"Sent: CPU={data['cpu']['usage']}%, "
-                          f"MEM={data['memory']['percent']}%, "
-                          f"DISK={data['disk']['percent']}%")
-            time.sleep(interval)
+            data, samples = collect(monitor, encoder, pacer.interval(), batch)
+            if sender.send(encoder.serialize(data, samples)):
+                log_print(f"Sent: {describe(data)}")
+            else:
+                # A new connection starts a new stream on the device
+                encoder.request_keyframe()
+            for payload, peer in sender.poll():
+                pacer.handle(payload, peer)
+            if batch <= 1:
+                time.sleep(pacer.interval())
     except KeyboardInterrupt:
         log_print("\nStopping...")
     finally:
         sender.close()
 
 
+def run_wifi_mode(host, port, interval, encoder, tcp=False, batch=1, ttl=1, counters=False, sensors=False):
+    """Run in WiFi mode (UDP datagrams, or a TCP stream)"""
+    sender = TCPSender(host, port) if tcp else WiFiSender(host, port, ttl)
+    run_loop(sender, interval, encoder, 'TCP' if tcp else 'WiFi', batch, counters, sensors)
+
+
 def main():
     global LOG_ENABLED
 
     parser = argparse.ArgumentParser(description='ESP32 System Monitor - PC Client')
-    parser.add_argument('--mode', choices=['wifi', 'ble'], default='wifi',
-                        help='Communication mode (default: wifi)')
+    parser.add_argument('--mode', choices=['wifi', 'tcp', 'ble', 'serial'], default='wifi',
+                        help='Communication mode: wifi (UDP), tcp, ble or serial (default: wifi)')
     parser.add_argument('--host', default='192.168.1.100',
-                        help='ESP32 IP address or mDNS hostname (WiFi mode, default: 192.168.1.100)')
+                        help='ESP32 IP address, mDNS hostname or multicast group (WiFi mode, default: 192.168.1.100)')
+    parser.add_argument('--multicast-ttl', type=int, default=1,
+                        help='Hops a multicast --host may cross; 1 keeps it on the local network (default: 1)')
     parser.add_argument('--port', type=int, default=8080,
-                        help='ESP32 UDP port (WiFi mode, default: 8080)')
+                        help='ESP32 UDP/TCP port (WiFi and TCP modes, default: 8080)')
     parser.add_argument('--device', default='ESP32_Monitor',
                         help='BLE device name (BLE mode, default: ESP32_Monitor)')
-    parser.add_argument('--interval', type=int, default=1,
-                        help='Update interval in seconds (default: 1)')
+    parser.add_argument('--serial-port', default='/dev/ttyUSB0',
+                        help='Serial port or pty path (serial mode, default: /dev/ttyUSB0)')
+    parser.add_argument('--baud', type=int, default=115200,
+                        help='Serial baud rate, must match setbaud on the device (default: 115200)')
+    parser.add_argument('--interval', type=float, default=1,
+                        help='Update interval in seconds; the device may ask for a longer one (default: 1)')
+    parser.add_argument('--delta', action='store_true',
+                        help='Send delta frames with periodic keyframes (default: full frames)')
+    parser.add_argument('--keyframe-interval', type=float, default=10.0,
+                        help='Seconds between keyframes in delta mode (default: 10)')
+    parser.add_argument('--multirate', action='store_true',
+                        help='Send each field group at its own rate: load 10 Hz, temperatures 1 Hz, '
+                             'capacities every 10 s (implies --delta; replaces --interval)')
+    parser.add_argument('--group-interval', action='append', default=[], metavar='GROUP=S',
+                        help=f'Seconds between updates of a field group in --multirate mode '
+                             f'({", ".join(FIELD_GROUPS)}); may be repeated')
+    parser.add_argument('--counters', action='store_true',
+                        help='Send raw network and disk I/O counters; the device derives the rates')
+    parser.add_argument('--sensors', action='store_true',
+                        help='Send fan speeds and any further GPUs as named sensors (JSON frames only)')
+    parser.add_argument('--binary', action='store_true',
+                        help='Send compact binary frames instead of JSON')
+    parser.add_argument('--compress', action='store_true',
+                        help='LZ4-compress frames against a dictionary of known keys (BLE mode)')
+    parser.add_argument('--batch', type=int, default=1,
+                        help=f'Samples per frame for higher-resolution graphs, up to {BATCH_MAX} (default: 1)')
+    parser.add_argument('--host-id', nargs='?', const=socket.gethostname(), default=None,
+                        help='Name this PC in every frame for multi-host displays '
+                             '(default when given without a value: the hostname)')
     parser.add_argument('--discover', action='store_true',
                         help='Discover ESP32 devices using mDNS and exit')
     parser.add_argument('--log', action='store_true',
@@ -434,7 +1281,11 @@ def main():
                 print(f"    Hostname: {device['hostname']}")
                 print(f"    IP Address: {', '.join(device['addresses'])}")
                 print(f"    Port: {device['port']}")
+                if device.get('group'):
+                    print(f"    Multicast Group: {device['group']}")
                 print(f"\nTo connect, use: --host {device['addresses'][0]} --port {device['port']}")
+                if device.get('group'):
+                    print(f"To feed every display in the group, use: --host {device['group']} --port {device['port']}")
         else:
             print("No devices found.")
             print("\nTroubleshooting:")
@@ -448,8 +1299,61 @@ def main():
     log_print("=" * 50)
     log_print(f"Mode: {args.mode.upper()}")
     log_print(f"Interval: {args.interval} seconds")
-
-    if args.mode == 'wifi':
+    if args.delta:
+        log_print(f"Delta frames: keyframe every {args.keyframe_interval} seconds")
+
+    if args.binary:
+        log_print("Binary frames")
+
+    if args.compress and args.mode != 'ble':
+        parser.error("--compress is only supported in BLE mode")
+    if args.compress:
+        log_print("Compressed frames")
+
+    if not 1 <= args.batch <= BATCH_MAX:
+        parser.error(f"--batch must be between 1 and {BATCH_MAX}")
+    if args.batch > 1:
+        log_print(f"Batch: {args.batch} samples per frame")
+
+    if args.host_id:
+        log_print(f"Host ID: {args.host_id}")
+
+    if args.counters:
+        log_print("Raw counters")
+
+    if args.sensors and args.binary:
+        parser.error("--sensors needs JSON frames; leave out --binary")
+    if args.sensors:
+        log_print("Extra sensors")
+
+    group_intervals = None
+    if args.group_interval and not args.multirate:
+        parser.error("--group-interval needs --multirate")
+    if args.multirate:
+        if args.batch > 1:
+            parser.error("--batch can't be combined with --multirate")
+        group_intervals = dict(GROUP_INTERVALS)
+        for spec in args.group_interval:
+            name, _, value = spec.partition('=')
+            try:
+                seconds = float(value)
+            except ValueError:
+                seconds = 0
+            if name not in group_intervals or seconds <= 0:
+                parser.error(f"--group-interval expects GROUP=SECONDS with GROUP one of "
+                             f"{', '.join(FIELD_GROUPS)}, got '{spec}'")
+            group_intervals[name] = seconds
+        log_print("Multi-rate groups: " + ", ".join(
+            f"{name} every {interval:g}s" if interval else f"{name} with keyframes"
+            for name, interval in group_intervals.items()))
+
+    encoder = FrameEncoder(delta=args.delta, keyframe_interval=args.keyframe_interval,
+                           binary=args.binary, host_id=args.host_id, compress=args.compress,
+                           group_intervals=group_intervals)
+    if group_intervals:
+        args.interval = encoder.tick()
+
+    if args.mode in ('wifi', 'tcp'):
         host = args.host
 
         # Try mDNS resolution if hostname ends with .local or doesn't look like an IP
@@ -463,11 +1367,19 @@ def main():
                 log_print(f"Warning: Could not resolve {host} via mDNS, trying as-is...")
 
         log_print(f"Target: {host}:{args.port}")
-        run_wifi_mode(host, args.port, args.interval)
+        if is_multicast(host) and args.mode == 'tcp':
+            parser.error("TCP mode needs a device address, not a multicast group")
+        run_wifi_mode(host, args.port, args.interval, encoder, tcp=args.mode == 'tcp',
+                      batch=args.batch, ttl=args.multicast_ttl, counters=args.counters,
+                      sensors=args.sensors)
+    elif args.mode == 'serial':
+        log_print(f"Port: {args.serial_port} @ {args.baud}")
+        run_serial_mode(args.serial_port, args.baud, args.interval, encoder, args.batch, args.counters,
+                        args.sensors)
     else:
         log_print(f"Device: {args.device}")
         import asyncio
-        asyncio.run(run_ble_mode(args.device, args.interval))
+        asyncio.run(run_ble_mode(args.device, args.interval, encoder, args.batch, args.counters, args.sensors))
 
 
 if __name__ == '__main__':
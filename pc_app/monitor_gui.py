@@ -28,7 +28,7 @@ from PyQt5.QtGui import QFont, QColor
 import sys
 import os
 sys.path.append(os.path.dirname(__file__))
-from monitor_client import SystemMonitor, WiFiSender
+from monitor_client import SystemMonitor, WiFiSender, FrameEncoder
 
 try:
     import serial
@@ -59,6 +59,7 @@ class MonitorWorker(QThread):
         self.interval = interval
         self.running = False
         self.monitor = SystemMonitor()
+        self.encoder = FrameEncoder()
         self.sender = None
 
     def run(self):
@@ -80,7 +81,7 @@ class MonitorWorker(QThread):
                     data = self.monitor.get_system_data()
 
                     # Send to ESP32
-                    if self.sender.send(data):
+                    if self.sender.send(self.encoder.serialize(data)):
                         self.data_updated.emit(data)
 
                     # Wait for next update